@@ -1,579 +1,6829 @@
-
-#include <iostream>
-#include <string>
-#include <vector>
-#include <ctime>
-#include <cstdio>   // sscanf
-#include <cctype>   // tolower
-#include <stdexcept>
-
-using namespace std;
-
-static string a_minusculas(const string& s) {
-    string r = s;
-    for (size_t i = 0; i < r.size(); ++i) r[i] = (char)tolower((unsigned char)r[i]);
-    return r;
-}
-
-static bool parsear_fecha(const string& s, int& y, int& m, int& d) {
-    return std::sscanf(s.c_str(), "%d-%d-%d", &y, &m, &d) == 3;
-}
-
-static string fecha_hoy() {
-    time_t t = time(NULL);
-    struct tm* lt = localtime(&t);
-    char buf[16];
-    if (lt) { strftime(buf, sizeof(buf), "%Y-%m-%d", lt); return string(buf); }
-    return string("1970-01-01");
-}
-
-static int calcular_edad(int y, int m, int d) {
-    time_t t = time(NULL);
-    struct tm* lt = localtime(&t);
-    if (!lt) return 0;
-    int anio = lt->tm_year + 1900;
-    int mes  = lt->tm_mon + 1;
-    int dia  = lt->tm_mday;
-    int edad = anio - y;
-    if (mes < m || (mes == m && dia < d)) edad--;
-    return edad;
-}
-
-
-enum Categoria {
-    CATEGORIA_ADMINISTRADOR = 0,
-    CATEGORIA_OPERARIO      = 1,
-    CATEGORIA_PEON          = 2
-};
-
-static string categoria_a_texto(Categoria c) {
-    switch (c) {
-        case CATEGORIA_ADMINISTRADOR: return "Administrador";
-        case CATEGORIA_OPERARIO:      return "Operario";
-        case CATEGORIA_PEON:          return "Peon";
-        default:                      return "Desconocida";
-    }
-}
-
-static bool texto_a_categoria(const string& texto, Categoria& out) {
-    string l = a_minusculas(texto);
-    if (l == "administrador") { out = CATEGORIA_ADMINISTRADOR; return true; }
-    if (l == "operario")      { out = CATEGORIA_OPERARIO;      return true; }
-    if (l == "peon")          { out = CATEGORIA_PEON;          return true; }
-    return false;
-}
-
-
-class Empleado {
-private:
-    string numero_carnet_;
-    string nombre_;
-    string fecha_nacimiento_; // "YYYY-MM-DD"
-    Categoria categoria_;
-    double salario_;
-    string direccion_;
-    string telefono_;
-    string correo_;
-
-    // simulacion de unicidad de correo
-    static vector<string> correos_usados_; // en minusculas
-
-    static bool correo_existe(const string& low) {
-        for (size_t i = 0; i < correos_usados_.size(); ++i)
-            if (correos_usados_[i] == low) return true;
-        return false;
-    }
-    static void registrar_correo(const string& low) { correos_usados_.push_back(low); }
-    static void eliminar_correo(const string& low) {
-        for (size_t i = 0; i < correos_usados_.size(); ++i) {
-            if (correos_usados_[i] == low) {
-                correos_usados_.erase(correos_usados_.begin() + (int)i);
-                return;
-            }
-        }
-    }
-
-    void validar_y_setear_fecha_nacimiento(const string& f) {
-        int y, m, d;
-        if (!parsear_fecha(f, y, m, d))
-            throw runtime_error("Fecha de nacimiento invalida (use YYYY-MM-DD).");
-        if (calcular_edad(y, m, d) < 18)
-            throw runtime_error("No se pueden contratar menores de edad.");
-        fecha_nacimiento_ = f;
-    }
-    void validar_y_setear_categoria(const string& cat_texto) {
-        Categoria c;
-        if (!texto_a_categoria(cat_texto, c))
-            throw runtime_error("Categoria invalida. Use: Administrador, Operario o Peon.");
-        categoria_ = c;
-    }
-    void validar_y_setear_salario(double s) {
-        if (s < 250000.0 || s > 500000.0)
-            throw runtime_error("El salario debe estar entre 250000 y 500000.");
-        salario_ = s;
-    }
-    void validar_y_setear_correo(const string& c) {
-        string low = a_minusculas(c);
-        if (low.empty())
-            throw runtime_error("El correo no puede estar vacio.");
-        if (!correo_.empty()) {
-            string anterior_low = a_minusculas(correo_);
-            if (anterior_low != low) eliminar_correo(anterior_low);
-            else return; // mismo correo
-        }
-        if (correo_existe(low))
-            throw runtime_error("El correo ya esta registrado.");
-        registrar_correo(low);
-        correo_ = c;
-    }
-
-public:
-    // constructor sin salario: asigna 250000 por defecto
-    Empleado(const string& carnet,
-             const string& nombre,
-             const string& fecha_nacimiento,
-             const string& categoria_texto,
-             const string& direccion,
-             const string& telefono,
-             const string& correo)
-        : numero_carnet_(carnet), nombre_(nombre), fecha_nacimiento_(""),
-          categoria_(CATEGORIA_OPERARIO), salario_(250000.0),
-          direccion_(direccion), telefono_(telefono), correo_("")
-    {
-        if (direccion_.empty()) direccion_ = "San Jose";
-        validar_y_setear_fecha_nacimiento(fecha_nacimiento);
-        validar_y_setear_categoria(categoria_texto);
-        validar_y_setear_correo(correo);
-    }
-
-    // constructor con salario
-    Empleado(const string& carnet,
-             const string& nombre,
-             const string& fecha_nacimiento,
-             const string& categoria_texto,
-             double salario,
-             const string& direccion,
-             const string& telefono,
-             const string& correo)
-        : numero_carnet_(carnet), nombre_(nombre), fecha_nacimiento_(""),
-          categoria_(CATEGORIA_OPERARIO), salario_(250000.0),
-          direccion_(direccion), telefono_(telefono), correo_("")
-    {
-        if (direccion_.empty()) direccion_ = "San Jose";
-        validar_y_setear_fecha_nacimiento(fecha_nacimiento);
-        validar_y_setear_categoria(categoria_texto);
-        validar_y_setear_salario(salario);
-        validar_y_setear_correo(correo);
-    }
-
-    // getters
-    const string& getCarnet() const { return numero_carnet_; }
-    const string& getNombre() const { return nombre_; }
-    const string& getFechaNacimiento() const { return fecha_nacimiento_; }
-    Categoria getCategoria() const { return categoria_; }
-    double getSalario() const { return salario_; }
-    const string& getDireccion() const { return direccion_; }
-    const string& getTelefono() const { return telefono_; }
-    const string& getCorreo() const { return correo_; }
-
-    // setters
-    void setNombre(const string& n) { nombre_ = n; }
-    void setFechaNacimiento(const string& f) { validar_y_setear_fecha_nacimiento(f); }
-    void setCategoria(const string& c) { validar_y_setear_categoria(c); }
-    void setSalario(double s) { validar_y_setear_salario(s); }
-    void setDireccion(const string& d) { direccion_ = d.empty() ? "San Jose" : d; }
-    void setTelefono(const string& t) { telefono_ = t; }
-    void setCorreo(const string& c) { validar_y_setear_correo(c); }
-
-    // mostrar info completa
-    void mostrar(ostream& os) const {
-        os << "Carnet: " << numero_carnet_ << "\n";
-        os << "Nombre: " << nombre_ << "\n";
-        os << "Fecha de nacimiento: " << fecha_nacimiento_ << " (edad aprox: ";
-        int y, m, d;
-        if (parsear_fecha(fecha_nacimiento_, y, m, d)) os << calcular_edad(y, m, d);
-        else os << "?";
-        os << ")\n";
-        os << "Categoria: " << categoria_a_texto(categoria_) << "\n";
-        os << "Salario: " << salario_ << "\n";
-        os << "Direccion: " << direccion_ << "\n";
-        os << "Telefono: " << telefono_ << "\n";
-        os << "Correo: " << correo_ << "\n";
-    }
-};
-
-vector<string> Empleado::correos_usados_;
-
-
-class Proyecto {
-private:
-    string codigo_;
-    string nombre_;
-    string fecha_inicio_;
-    string fecha_finalizacion_;
-
-    // nombres unicos (simulacion)
-    static vector<string> nombres_usados_; // en minusculas
-
-    static bool nombre_existe(const string& low) {
-        for (size_t i = 0; i < nombres_usados_.size(); ++i)
-            if (nombres_usados_[i] == low) return true;
-        return false;
-    }
-    static void registrar_nombre(const string& low) { nombres_usados_.push_back(low); }
-    static void eliminar_nombre(const string& low) {
-        for (size_t i = 0; i < nombres_usados_.size(); ++i) {
-            if (nombres_usados_[i] == low) {
-                nombres_usados_.erase(nombres_usados_.begin() + (int)i);
-                return;
-            }
-        }
-    }
-    void validar_y_setear_nombre(const string& n) {
-        string low = a_minusculas(n);
-        if (low.empty())
-            throw runtime_error("El nombre del proyecto no puede estar vacio.");
-        if (!nombre_.empty()) {
-            string anterior_low = a_minusculas(nombre_);
-            if (anterior_low != low) eliminar_nombre(anterior_low);
-            else return;
-        }
-        if (nombre_existe(low))
-            throw runtime_error("El nombre del proyecto ya existe.");
-        registrar_nombre(low);
-        nombre_ = n;
-    }
-
-public:
-    Proyecto(const string& codigo, const string& nombre,
-             const string& fecha_inicio, const string& fecha_fin)
-        : codigo_(codigo), nombre_(""),
-          fecha_inicio_(fecha_inicio), fecha_finalizacion_(fecha_fin)
-    { validar_y_setear_nombre(nombre); }
-
-    // getters
-    const string& getCodigo() const { return codigo_; }
-    const string& getNombre() const { return nombre_; }
-    const string& getFechaInicio() const { return fecha_inicio_; }
-    const string& getFechaFinalizacion() const { return fecha_finalizacion_; }
-
-    // setters
-    void setNombre(const string& n) { validar_y_setear_nombre(n); }
-    void setFechaInicio(const string& f) { fecha_inicio_ = f; }
-    void setFechaFinalizacion(const string& f) { fecha_finalizacion_ = f; }
-
-    // mostrar
-    void mostrar(ostream& os) const {
-        os << "Codigo: " << codigo_ << "\n";
-        os << "Nombre: " << nombre_ << "\n";
-        os << "Fecha de inicio: " << fecha_inicio_ << "\n";
-        os << "Fecha de finalizacion: " << fecha_finalizacion_ << "\n";
-    }
-};
-
-vector<string> Proyecto::nombres_usados_;
-
-
-class GestorSistema {
-private:
-    vector<Empleado> empleados_;
-    vector<Proyecto> proyectos_;
-
-    struct Asignacion {
-        string carnet_empleado;
-        string codigo_proyecto;
-        string fecha_asignacion; // "YYYY-MM-DD"
-    };
-    vector<Asignacion> asignaciones_;
-
-    // helpers de busqueda lineal
-    int buscarEmpleadoPorCarnet(const string& carnet) const {
-        for (size_t i = 0; i < empleados_.size(); ++i)
-            if (empleados_[i].getCarnet() == carnet) return (int)i;
-        return -1;
-    }
-    int buscarProyectoPorCodigo(const string& codigo) const {
-        for (size_t i = 0; i < proyectos_.size(); ++i)
-            if (proyectos_[i].getCodigo() == codigo) return (int)i;
-        return -1;
-    }
-    bool asignacionExiste(const string& carnet, const string& codigo) const {
-        for (size_t i = 0; i < asignaciones_.size(); ++i)
-            if (asignaciones_[i].carnet_empleado == carnet &&
-                asignaciones_[i].codigo_proyecto == codigo) return true;
-        return false;
-    }
-
-public:
-    // crear empleado sin salario (250000 por defecto)
-    bool crearEmpleado(const string& carnet, const string& nombre,
-                       const string& fecha_nac, const string& categoria,
-                       const string& direccion, const string& telefono,
-                       const string& correo)
-    {
-        if (buscarEmpleadoPorCarnet(carnet) != -1) {
-            cout << "Aviso: ya existe un empleado con ese carnet.\n";
-            return false;
-        }
-        try {
-            Empleado e(carnet, nombre, fecha_nac, categoria, direccion, telefono, correo);
-            empleados_.push_back(e);
-            return true;
-        } catch (const std::exception& ex) {
-            cout << "Error al crear empleado: " << ex.what() << "\n";
-            return false;
-        }
-    }
-
-    // crear empleado con salario
-    bool crearEmpleado(const string& carnet, const string& nombre,
-                       const string& fecha_nac, const string& categoria,
-                       double salario, const string& direccion,
-                       const string& telefono, const string& correo)
-    {
-        if (buscarEmpleadoPorCarnet(carnet) != -1) {
-            cout << "Aviso: ya existe un empleado con ese carnet.\n";
-            return false;
-        }
-        try {
-            Empleado e(carnet, nombre, fecha_nac, categoria, salario, direccion, telefono, correo);
-            empleados_.push_back(e);
-            return true;
-        } catch (const std::exception& ex) {
-            cout << "Error al crear empleado: " << ex.what() << "\n";
-            return false;
-        }
-    }
-
-    // crear proyecto
-    bool crearProyecto(const string& codigo, const string& nombre,
-                       const string& fecha_inicio, const string& fecha_fin)
-    {
-        if (buscarProyectoPorCodigo(codigo) != -1) {
-            cout << "Aviso: ya existe un proyecto con ese codigo.\n";
-            return false;
-        }
-        try {
-            Proyecto p(codigo, nombre, fecha_inicio, fecha_fin);
-            proyectos_.push_back(p);
-            return true;
-        } catch (const std::exception& ex) {
-            cout << "Error al crear proyecto: " << ex.what() << "\n";
-            return false;
-        }
-    }
-
-    // listar empleados
-    void listarEmpleados(ostream& os) const {
-        os << "--- LISTA DE EMPLEADOS ---\n";
-        for (size_t i = 0; i < empleados_.size(); ++i) {
-            os << "--------------------------\n";
-            empleados_[i].mostrar(os);
-        }
-        os << "==========================\n";
-    }
-
-    // listar proyectos
-    void listarProyectos(ostream& os) const {
-        os << "--- LISTA DE PROYECTOS ---\n";
-        for (size_t i = 0; i < proyectos_.size(); ++i) {
-            os << "--------------------------\n";
-            proyectos_[i].mostrar(os);
-        }
-        os << "==========================\n";
-    }
-
-    // asignar empleado a proyecto (fecha actual), sin duplicados
-    bool asignarEmpleadoAProyecto(const string& carnet, const string& codigo) {
-        int idxE = buscarEmpleadoPorCarnet(carnet);
-        if (idxE == -1) { cout << "No existe el empleado.\n"; return false; }
-
-        int idxP = buscarProyectoPorCodigo(codigo);
-        if (idxP == -1) { cout << "No existe el proyecto.\n"; return false; }
-
-        if (asignacionExiste(carnet, codigo)) {
-            cout << "El empleado ya esta asignado a ese proyecto.\n";
-            return false;
-        }
-
-        Asignacion a;
-        a.carnet_empleado = carnet;
-        a.codigo_proyecto = codigo;
-        a.fecha_asignacion = fecha_hoy();
-        asignaciones_.push_back(a);
-        return true;
-    }
-
-    // listar empleados asignados a un proyecto
-    void listarEmpleadosDeProyecto(const string& codigo, ostream& os) const {
-        int idxP = buscarProyectoPorCodigo(codigo);
-        if (idxP == -1) { os << "Proyecto no encontrado.\n"; return; }
-
-        os << "--- EMPLEADOS EN PROYECTO [" << codigo << "] ---\n";
-        for (size_t i = 0; i < asignaciones_.size(); ++i) {
-            if (asignaciones_[i].codigo_proyecto == codigo) {
-                int idxE = buscarEmpleadoPorCarnet(asignaciones_[i].carnet_empleado);
-                if (idxE != -1) {
-                    os << "- " << empleados_[idxE].getCarnet()
-                       << " | " << empleados_[idxE].getNombre()
-                       << " | Categoria: " << categoria_a_texto(empleados_[idxE].getCategoria())
-                       << " | Asignado el: " << asignaciones_[i].fecha_asignacion
-                       << "\n";
-                }
-            }
-        }
-        os << "=============================================\n";
-    }
-
-    // listar proyectos en los que trabaja un empleado
-    void listarProyectosDeEmpleado(const string& carnet, ostream& os) const {
-        int idxE = buscarEmpleadoPorCarnet(carnet);
-        if (idxE == -1) { os << "Empleado no encontrado.\n"; return; }
-
-        os << "--- PROYECTOS DEL EMPLEADO [" << carnet << "] ---\n";
-        for (size_t i = 0; i < asignaciones_.size(); ++i) {
-            if (asignaciones_[i].carnet_empleado == carnet) {
-                int idxP = buscarProyectoPorCodigo(asignaciones_[i].codigo_proyecto);
-                if (idxP != -1) {
-                    os << "- " << proyectos_[idxP].getCodigo()
-                       << " | " << proyectos_[idxP].getNombre()
-                       << " | Asignado el: " << asignaciones_[i].fecha_asignacion
-                       << "\n";
-                }
-            }
-        }
-        os << "=============================================\n";
-    }
-};
-
-
-static void pausar() {
-    cout << "Presione ENTER para continuar...";
-    cin.ignore(10000, '\n');
-}
-
-static string leer_linea(const string& prompt) {
-    cout << prompt;
-    string s;
-    getline(cin, s);
-    return s;
-}
-
-static double leer_double(const string& prompt) {
-    while (true) {
-        cout << prompt;
-        string s; getline(cin, s);
-        double val = 0.0;
-        if (std::sscanf(s.c_str(), "%lf", &val) == 1) return val;
-        cout << "Entrada invalida, intente de nuevo.\n";
-    }
-}
-
-static int leer_opcion() {
-    string s; getline(cin, s);
-    int op = -1;
-    std::sscanf(s.c_str(), "%d", &op);
-    return op;
-}
-
-
-static void imprimir_menu() {
-    cout << "\n--- MENU SISTEMA CONSTRUCTORES AVANCE ---\n";
-    cout << "1) Crear empleado (salario por defecto 250000)\n";
-    cout << "2) Crear empleado (con salario)\n";
-    cout << "3) Listar empleados\n";
-    cout << "4) Crear proyecto\n";
-    cout << "5) Listar proyectos\n";
-    cout << "6) Asignar empleado a proyecto\n";
-    cout << "7) Listar empleados de un proyecto\n";
-    cout << "8) Listar proyectos de un empleado\n";
-    cout << "0) Salir\n";
-    cout << "Seleccione opcion: ";
-}
-
-int main() {
-    GestorSistema gs;
-
-    while (true) {
-        imprimir_menu();
-        int op = leer_opcion();
-
-        if (op == 0) {
-            cout << "Saliendo...\n";
-            break;
-        }
-
-        if (op == 1) {
-            cout << "\n-- Crear empleado (salario por defecto) --\n";
-            string carnet = leer_linea("Carnet: ");
-            string nombre = leer_linea("Nombre: ");
-            string fnac   = leer_linea("Fecha de nacimiento (YYYY-MM-DD): ");
-            string cat    = leer_linea("Categoria (Administrador/Operario/Peon): ");
-            string dir    = leer_linea("Direccion (vacio -> San Jose): ");
-            string tel    = leer_linea("Telefono: ");
-            string corr   = leer_linea("Correo: ");
-
-            bool ok = gs.crearEmpleado(carnet, nombre, fnac, cat, dir, tel, corr);
-            if (ok) cout << "Empleado creado.\n";
-            else    cout << "No se creo el empleado.\n";
-        }
-        else if (op == 2) {
-            cout << "\n-- Crear empleado (con salario) --\n";
-            string carnet = leer_linea("Carnet: ");
-            string nombre = leer_linea("Nombre: ");
-            string fnac   = leer_linea("Fecha de nacimiento (YYYY-MM-DD): ");
-            string cat    = leer_linea("Categoria (Administrador/Operario/Peon): ");
-            double sal    = leer_double("Salario (250000..500000): ");
-            string dir    = leer_linea("Direccion (vacio -> San Jose): ");
-            string tel    = leer_linea("Telefono: ");
-            string corr   = leer_linea("Correo: ");
-
-            bool ok = gs.crearEmpleado(carnet, nombre, fnac, cat, sal, dir, tel, corr);
-            if (ok) cout << "Empleado creado.\n";
-            else    cout << "No se creo el empleado.\n";
-        }
-        else if (op == 3) {
-            cout << "\n-- Lista de empleados --\n";
-            gs.listarEmpleados(std::cout);
-        }
-        else if (op == 4) {
-            cout << "\n-- Crear proyecto --\n";
-            string cod  = leer_linea("Codigo del proyecto: ");
-            string nom  = leer_linea("Nombre del proyecto (unico): ");
-            string ini  = leer_linea("Fecha de inicio (YYYY-MM-DD): ");
-            string fin  = leer_linea("Fecha de finalizacion (YYYY-MM-DD): ");
-
-            bool ok = gs.crearProyecto(cod, nom, ini, fin);
-            if (ok) cout << "Proyecto creado.\n";
-            else    cout << "No se creo el proyecto.\n";
-        }
-        else if (op == 5) {
-            cout << "\n-- Lista de proyectos --\n";
-            gs.listarProyectos(std::cout);
-        }
-        else if (op == 6) {
-            cout << "\n-- Asignar empleado a proyecto --\n";
-            string carnet = leer_linea("Carnet del empleado: ");
-            string codigo = leer_linea("Codigo del proyecto: ");
-            bool ok = gs.asignarEmpleadoAProyecto(carnet, codigo);
-            if (ok) cout << "Asignacion realizada.\n";
-            else    cout << "No se realizo la asignacion.\n";
-        }
-        else if (op == 7) {
-            cout << "\n-- Empleados de un proyecto --\n";
-            string codigo = leer_linea("Codigo del proyecto: ");
-            gs.listarEmpleadosDeProyecto(codigo, std::cout);
-        }
-        else if (op == 8) {
-            cout << "\n-- Proyectos de un empleado --\n";
-            string carnet = leer_linea("Carnet del empleado: ");
-            gs.listarProyectosDeEmpleado(carnet, std::cout);
-        }
-        else {
-            cout << "Opcion invalida.\n";
-        }
-    }
-
-    return 0;
-}
-
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <ctime>
+#include <cstdio>   // sscanf
+#include <cctype>   // tolower
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>  // strtod
+#include <cstring>  // memcpy
+#include <cerrno>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cmath>    // llround
+#include <sstream>
+#include <string_view>
+#include <charconv> // to_chars (exportacion)
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable> // exportacion por tramos
+#ifdef _WIN32
+#include <direct.h> // _mkdir
+#include <io.h>     // _commit
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h> // servidor local
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <signal.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2 (benchmark de memoria)
+#endif
+
+using namespace std;
+
+static string a_minusculas(string_view s) {
+    string r(s);
+    for (size_t i = 0; i < r.size(); ++i) r[i] = (char)tolower((unsigned char)r[i]);
+    return r;
+}
+
+// orden sin distinguir mayusculas (indices de prefijo); compara en su lugar, sin copias
+static int comparar_sin_mayusculas(string_view a, string_view b) {
+    size_t n = a.size() < b.size() ? a.size() : b.size();
+    for (size_t i = 0; i < n; ++i) {
+        int x = tolower((unsigned char)a[i]), y = tolower((unsigned char)b[i]);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+static bool empieza_sin_mayusculas(string_view s, string_view prefijo) {
+    return s.size() >= prefijo.size() && comparar_sin_mayusculas(s.substr(0, prefijo.size()), prefijo) == 0;
+}
+
+// version reentrante de localtime (la validacion corre en varios hilos)
+static bool hora_local(time_t t, struct tm& out) {
+#ifdef _WIN32
+    return localtime_s(&out, &t) == 0;
+#else
+    return localtime_r(&t, &out) != NULL;
+#endif
+}
+
+// ---- fechas: dias desde 1970-01-01 en un int32 ----
+// conversion civil <-> dias (calendario gregoriano proleptico, algoritmo de H. Hinnant)
+struct FechaCivil {
+    int anio;
+    int mes;
+    int dia;
+};
+
+static constexpr bool es_bisiesto(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static constexpr int dias_del_mes(int y, int m) {
+    return m == 2 ? (es_bisiesto(y) ? 29 : 28)
+                  : ((m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31);
+}
+
+static constexpr int32_t dias_desde_civil(int y, int m, int d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static constexpr FechaCivil civil_desde_dias(int32_t z) {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    const int d = doy - (153 * mp + 2) / 5 + 1;
+    const int m = mp < 10 ? mp + 3 : mp - 9;
+    return FechaCivil{ yoe + era * 400 + (m <= 2), m, d };
+}
+
+static_assert(dias_desde_civil(1970, 1, 1) == 0, "epoca");
+static_assert(dias_desde_civil(2000, 3, 1) == 11017, "bisiesto 2000");
+static_assert(civil_desde_dias(11017).mes == 3 && civil_desde_dias(11017).dia == 1, "ida y vuelta");
+
+// fecha validada una sola vez al ingresar; luego comparar y restar son operaciones enteras
+class Fecha {
+private:
+    int32_t dias_;
+
+public:
+    constexpr Fecha() : dias_(0) {}
+    constexpr explicit Fecha(int32_t dias) : dias_(dias) {}
+    static constexpr Fecha desdeCivil(int y, int m, int d) { return Fecha(dias_desde_civil(y, m, d)); }
+
+    constexpr int32_t dias() const { return dias_; }
+    constexpr FechaCivil civil() const { return civil_desde_dias(dias_); }
+
+    // "YYYY-MM-DD" (mes y dia de 1 o 2 digitos); rechaza fechas imposibles como 2023-02-30
+    static bool parsear(const string& s, Fecha& out) {
+        int campos[3] = { 0, 0, 0 };
+        const int max_digitos[3] = { 4, 2, 2 };
+        size_t i = 0;
+        while (i < s.size() && isspace((unsigned char)s[i])) ++i;
+        for (int k = 0; k < 3; ++k) {
+            int n = 0;
+            while (i < s.size() && isdigit((unsigned char)s[i]) && n < max_digitos[k]) {
+                campos[k] = campos[k] * 10 + (s[i] - '0');
+                ++i; ++n;
+            }
+            if (n == 0) return false;
+            if (k < 2) {
+                if (i >= s.size() || s[i] != '-') return false;
+                ++i;
+            }
+        }
+        while (i < s.size() && isspace((unsigned char)s[i])) ++i;
+        if (i != s.size()) return false;
+        int y = campos[0], m = campos[1], d = campos[2];
+        if (y < 1 || m < 1 || m > 12 || d < 1 || d > dias_del_mes(y, m)) return false;
+        out = desdeCivil(y, m, d);
+        return true;
+    }
+
+    // escribe "YYYY-MM-DD" (10 caracteres, sin terminador)
+    void escribir(char* buf) const {
+        FechaCivil c = civil();
+        int y = c.anio;
+        buf[0] = (char)('0' + (y / 1000) % 10);
+        buf[1] = (char)('0' + (y / 100) % 10);
+        buf[2] = (char)('0' + (y / 10) % 10);
+        buf[3] = (char)('0' + y % 10);
+        buf[4] = '-';
+        buf[5] = (char)('0' + c.mes / 10);
+        buf[6] = (char)('0' + c.mes % 10);
+        buf[7] = '-';
+        buf[8] = (char)('0' + c.dia / 10);
+        buf[9] = (char)('0' + c.dia % 10);
+    }
+    string texto() const { char buf[10]; escribir(buf); return string(buf, 10); }
+
+    // fecha local actual; se consulta una vez por operacion o por lote
+    static Fecha hoy() {
+        struct tm lt;
+        if (!hora_local(time(NULL), lt)) return Fecha();
+        return desdeCivil(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday);
+    }
+
+    bool operator==(Fecha o) const { return dias_ == o.dias_; }
+    bool operator!=(Fecha o) const { return dias_ != o.dias_; }
+    bool operator<(Fecha o) const { return dias_ < o.dias_; }
+    bool operator<=(Fecha o) const { return dias_ <= o.dias_; }
+    bool operator>(Fecha o) const { return dias_ > o.dias_; }
+    bool operator>=(Fecha o) const { return dias_ >= o.dias_; }
+};
+
+inline ostream& operator<<(ostream& os, Fecha f) {
+    char buf[10];
+    f.escribir(buf);
+    return os.write(buf, 10);
+}
+
+static int calcular_edad(Fecha nacimiento, Fecha hoy) {
+    FechaCivil n = nacimiento.civil();
+    FechaCivil h = hoy.civil();
+    int edad = h.anio - n.anio;
+    if (h.mes < n.mes || (h.mes == n.mes && h.dia < n.dia)) edad--;
+    return edad;
+}
+
+
+// buffer de salida reutilizable: acumula el texto formateado y lo vuelca
+// al ostream destino en bloques grandes (un write por cada ~64 KB)
+class BufferSalida {
+private:
+    string buf_;
+    ostream* destino_;
+    size_t umbral_;
+
+    void revisar() { if (destino_ && buf_.size() >= umbral_) volcar(); }
+
+public:
+    explicit BufferSalida(ostream* destino = NULL, size_t umbral = 1 << 16)
+        : destino_(destino), umbral_(umbral) { buf_.reserve(umbral + 4096); }
+    ~BufferSalida() { volcar(); }
+
+    BufferSalida& operator<<(const string& s) { buf_.append(s); revisar(); return *this; }
+    BufferSalida& operator<<(string_view s) { buf_.append(s.data(), s.size()); revisar(); return *this; }
+    BufferSalida& operator<<(const char* s) { buf_.append(s); revisar(); return *this; }
+    BufferSalida& operator<<(char c) { buf_.push_back(c); return *this; }
+    BufferSalida& operator<<(Fecha f) {
+        char tmp[10];
+        f.escribir(tmp);
+        buf_.append(tmp, 10);
+        return *this;
+    }
+    BufferSalida& operator<<(int v) { return entero((long long)v); }
+    BufferSalida& operator<<(long v) { return entero((long long)v); }
+    BufferSalida& operator<<(long long v) { return entero(v); }
+    BufferSalida& operator<<(unsigned v) { return natural((unsigned long long)v); }
+    BufferSalida& operator<<(unsigned long v) { return natural((unsigned long long)v); }
+    BufferSalida& operator<<(unsigned long long v) { return natural(v); }
+    // mismo formato que ostream por defecto (%g, 6 digitos significativos)
+    BufferSalida& operator<<(double v) {
+        char tmp[32];
+        int n = std::snprintf(tmp, sizeof(tmp), "%g", v);
+        buf_.append(tmp, n > 0 ? (size_t)n : 0);
+        return *this;
+    }
+
+    BufferSalida& entero(long long v) {
+        if (v < 0) { buf_.push_back('-'); return natural((unsigned long long)(-(v + 1)) + 1); }
+        return natural((unsigned long long)v);
+    }
+    BufferSalida& natural(unsigned long long v) {
+        char tmp[24];
+        int i = 24;
+        do { tmp[--i] = (char)('0' + v % 10); v /= 10; } while (v);
+        buf_.append(tmp + i, (size_t)(24 - i));
+        return *this;
+    }
+
+    void volcar() {
+        if (destino_ && !buf_.empty()) {
+            destino_->write(buf_.data(), (streamsize)buf_.size());
+            buf_.clear();
+        }
+    }
+    const string& str() const { return buf_; }
+    void limpiar() { buf_.clear(); }
+};
+
+
+// ---- almacenamiento de cadenas ----
+// arena de solo-agregar con internado: cada valor distinto se guarda una vez en
+// bloques que nunca se mueven, asi las string_view entregadas siguen validas
+// mientras viva el pool
+class PoolCadenas {
+private:
+    static const size_t TAM_BLOQUE = 64 * 1024;
+    vector<unique_ptr<char[]> > bloques_;
+    char* libre_;      // siguiente byte libre del bloque actual
+    size_t restante_;  // bytes libres en el bloque actual
+    size_t reservado_; // total pedido al sistema
+    unordered_set<string_view> vistas_;
+
+    char* reservar(size_t n) {
+        if (n > TAM_BLOQUE / 4) { // cadenas grandes: bloque propio, el actual sigue en uso
+            bloques_.push_back(unique_ptr<char[]>(new char[n]));
+            reservado_ += n;
+            return bloques_.back().get();
+        }
+        if (n > restante_) {
+            bloques_.push_back(unique_ptr<char[]>(new char[TAM_BLOQUE]));
+            reservado_ += TAM_BLOQUE;
+            libre_ = bloques_.back().get();
+            restante_ = TAM_BLOQUE;
+        }
+        char* r = libre_;
+        libre_ += n;
+        restante_ -= n;
+        return r;
+    }
+
+public:
+    PoolCadenas() : libre_(NULL), restante_(0), reservado_(0) {}
+
+    string_view internar(string_view s) {
+        if (s.empty()) return string_view();
+        unordered_set<string_view>::const_iterator it = vistas_.find(s);
+        if (it != vistas_.end()) return *it;
+        char* p = reservar(s.size());
+        std::memcpy(p, s.data(), s.size());
+        string_view v(p, s.size());
+        vistas_.insert(v);
+        return v;
+    }
+    size_t cantidad() const { return vistas_.size(); }
+    size_t bytesReservados() const { return reservado_; }
+    // para llenarlo sin rehashes intermedios (compactacion)
+    void preparar(size_t n) { vistas_.reserve(n); }
+    // vacia un pool que ya no se usa, de a poco: hasta n entradas del indice por llamada
+    // y, si nadie mas tiene vistas a sus textos ('exclusivo'), un bloque. Destruirlo de una
+    // vez son millones de nodos, y la primera liberacion grande despues los consolida todos
+    // juntos (una pausa larga). true cuando ya no queda nada que soltar de a poco
+    bool soltar(size_t n, bool exclusivo) {
+        while (n > 0 && !vistas_.empty()) {
+            vistas_.erase(vistas_.begin());
+            --n;
+        }
+        if (exclusivo && !bloques_.empty()) {
+            bloques_.pop_back();
+            libre_ = NULL;
+            restante_ = 0;
+        }
+        if (!vistas_.empty() || (exclusivo && !bloques_.empty())) return false;
+        unordered_set<string_view>().swap(vistas_);
+        return true;
+    }
+};
+
+// N campos de texto como vistas: en un objeto suelto apuntan a un buffer propio
+// (una sola reserva por objeto); al internarlos apuntan al PoolCadenas del gestor
+// y el buffer se libera
+template <int N>
+class CamposTexto {
+private:
+    string_view campo_[N];
+    unique_ptr<char[]> propio_; // los valores seguidos, en orden; nulo una vez internados
+
+    size_t largoTotal() const {
+        size_t total = 0;
+        for (int i = 0; i < N; ++i) total += campo_[i].size();
+        return total;
+    }
+    // reapunta las vistas del buffer 'viejo' (ya copiado) a propio_
+    void reubicar(const char* viejo) {
+        for (int i = 0; i < N; ++i)
+            campo_[i] = campo_[i].empty() ? string_view()
+                                          : string_view(propio_.get() + (campo_[i].data() - viejo), campo_[i].size());
+    }
+    void copiar(const CamposTexto& o) {
+        for (int i = 0; i < N; ++i) campo_[i] = o.campo_[i];
+        if (!o.propio_) { propio_.reset(); return; }
+        size_t total = o.largoTotal();
+        propio_.reset(new char[total]);
+        std::memcpy(propio_.get(), o.propio_.get(), total);
+        reubicar(o.propio_.get());
+    }
+    // el bloque no se mueve: las vistas siguen validas tal cual
+    void mover(CamposTexto& o) {
+        propio_ = std::move(o.propio_);
+        for (int i = 0; i < N; ++i) { campo_[i] = o.campo_[i]; o.campo_[i] = string_view(); }
+    }
+
+public:
+    CamposTexto() {}
+    CamposTexto(const CamposTexto& o) { copiar(o); }
+    CamposTexto(CamposTexto&& o) noexcept { mover(o); }
+    CamposTexto& operator=(const CamposTexto& o) { if (this != &o) copiar(o); return *this; }
+    CamposTexto& operator=(CamposTexto&& o) noexcept { if (this != &o) mover(o); return *this; }
+
+    string_view get(int i) const { return campo_[i]; }
+
+    // copia todos los valores a un buffer nuevo (pueden apuntar al buffer actual)
+    void fijar(const string_view* v) {
+        size_t total = 0;
+        for (int i = 0; i < N; ++i) total += v[i].size();
+        unique_ptr<char[]> nuevo(total ? new char[total] : NULL);
+        size_t off = 0;
+        for (int i = 0; i < N; ++i) {
+            if (v[i].empty()) { campo_[i] = string_view(); continue; }
+            std::memcpy(nuevo.get() + off, v[i].data(), v[i].size());
+            campo_[i] = string_view(nuevo.get() + off, v[i].size());
+            off += v[i].size();
+        }
+        propio_.swap(nuevo);
+    }
+    void set(int i, string_view valor) {
+        string_view v[N];
+        for (int k = 0; k < N; ++k) v[k] = (k == i) ? valor : campo_[k];
+        fijar(v);
+    }
+    void internar(PoolCadenas& pool) {
+        for (int i = 0; i < N; ++i) campo_[i] = pool.internar(campo_[i]);
+        propio_.reset();
+    }
+};
+
+// ---- campos frios de los empleados (direccion y telefono) ----
+// solo se leen al mostrar un empleado, en el diario y en el snapshot; nunca en
+// busquedas, asignaciones ni nomina. Sin archivo viven en un pool como el resto de
+// los textos. Con archivo se agregan al final de un archivo de trabajo (se descarta
+// al cerrar: lo durable sigue siendo snapshot + diario) y se leen a traves de una
+// cache LRU acotada, asi la memoria no crece con ellos.
+class AlmacenFrio {
+public:
+    struct Contacto {
+        string direccion, telefono;
+    };
+
+private:
+    // datos_ cubre lo que crece (referencias, pool, cola, archivo): exclusivo solo al
+    // guardar, compartido al leer, asi los lectores no se excluyen entre si. Lo toma
+    // tambien el hilo del snapshot, que lee sin el candado del gestor
+    mutable shared_mutex datos_;
+    // en memoria
+    PoolCadenas pool_;
+    vector<pair<string_view, string_view> > en_memoria_;
+    // en disco: registro = [u32 largo direccion][u32 largo telefono][bytes]
+    static const size_t TAM_COLA = 1 << 16;
+    FILE* f_;
+#ifdef _WIN32
+    FILE* lector_;          // sin pread: lecturas con fseek sobre su propio FILE
+    mutable mutex lectura_;
+#endif
+    string ruta_;
+    vector<uint64_t> desplazamientos_;
+    uint64_t fin_;     // bytes de registros guardados (archivo + cola)
+    uint64_t escrito_; // de esos, los que ya estan en el archivo
+    string cola_;      // registros aun no escritos; si escribir falla se quedan aqui
+    mutable atomic<bool> fallo_;
+    // cache LRU (lo mas reciente al frente) en trozos por referencia, cada uno con su
+    // candado: dos lectores solo se esperan si caen en el mismo trozo
+    typedef list<pair<uint32_t, Contacto> > ListaLru;
+    static const size_t TROZOS_CACHE = 16;
+    struct alignas(64) TrozoCache {
+        mutex m;
+        ListaLru lru;
+        unordered_map<uint32_t, ListaLru::iterator> indice;
+        size_t aciertos, fallos;
+        TrozoCache() : aciertos(0), fallos(0) {}
+    };
+    size_t capacidad_; // por trozo
+    mutable TrozoCache cache_[TROZOS_CACHE];
+
+    bool leerEn(uint64_t pos, char* p, size_t n) const {
+#ifdef _WIN32
+        lock_guard<mutex> l(lectura_);
+        return _fseeki64(lector_, (long long)pos, SEEK_SET) == 0 && fread(p, 1, n, lector_) == n;
+#else
+        while (n > 0) {
+            ssize_t r = pread(fileno(f_), p, n, (off_t)pos);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) return false;
+            p += r;
+            pos += (uint64_t)r;
+            n -= (size_t)r;
+        }
+        return true;
+#endif
+    }
+    // bajo datos_ (compartido)
+    bool leerRegistro(uint32_t ref, Contacto& out) const {
+        uint64_t off = desplazamientos_[ref];
+        size_t tam = (size_t)((ref + 1 < desplazamientos_.size() ? desplazamientos_[ref + 1] : fin_) - off);
+        string registro;
+        const char* r;
+        if (off >= escrito_) {
+            r = cola_.data() + (off - escrito_);
+        } else {
+            registro.resize(tam);
+            if (!leerEn(off, &registro[0], tam)) return false;
+            r = registro.data();
+        }
+        uint32_t largos[2];
+        std::memcpy(largos, r, 8);
+        if ((uint64_t)largos[0] + largos[1] + 8 != tam) return false;
+        out.direccion.assign(r + 8, largos[0]);
+        out.telefono.assign(r + 8 + largos[0], largos[1]);
+        return true;
+    }
+    // pasa la cola al archivo; si falla se queda en memoria (no se pierde nada) y no se
+    // reintenta: desde ahi el almacen crece en memoria como si no tuviera archivo
+    void volcarCola() {
+        if (fwrite(cola_.data(), 1, cola_.size(), f_) != cola_.size() || fflush(f_) != 0) {
+            fallo_ = true;
+            return;
+        }
+        escrito_ += cola_.size();
+        cola_.clear();
+    }
+
+public:
+    AlmacenFrio() : f_(NULL),
+#ifdef _WIN32
+                    lector_(NULL),
+#endif
+                    fin_(0), escrito_(0), fallo_(false), capacidad_(0) {}
+    ~AlmacenFrio() { cerrar(); }
+    AlmacenFrio(const AlmacenFrio&) = delete;
+    AlmacenFrio& operator=(const AlmacenFrio&) = delete;
+
+    // pasa a disco; solo antes de guardar el primer registro
+    bool abrir(const string& ruta, size_t capacidad_cache, string& error) {
+        unique_lock<shared_mutex> l(datos_);
+        if (!en_memoria_.empty() || !desplazamientos_.empty()) { error = "El almacen frio ya tiene registros."; return false; }
+        f_ = fopen(ruta.c_str(), "w+b");
+        if (!f_) { error = "No se pudo crear " + ruta; return false; }
+        setvbuf(f_, NULL, _IONBF, 0); // la cola ya agrupa las escrituras
+#ifdef _WIN32
+        lector_ = fopen(ruta.c_str(), "rb");
+        if (!lector_) { fclose(f_); f_ = NULL; error = "No se pudo abrir " + ruta; return false; }
+        setvbuf(lector_, NULL, _IONBF, 0);
+#endif
+        ruta_ = ruta;
+        capacidad_ = (capacidad_cache + TROZOS_CACHE - 1) / TROZOS_CACHE;
+        return true;
+    }
+    void cerrar() {
+        unique_lock<shared_mutex> l(datos_);
+        if (!f_) return;
+#ifdef _WIN32
+        fclose(lector_);
+        lector_ = NULL;
+#endif
+        fclose(f_);
+        f_ = NULL;
+        std::remove(ruta_.c_str());
+    }
+
+    // agrega un registro y devuelve su referencia (bajo el candado exclusivo del gestor)
+    uint32_t guardar(string_view direccion, string_view telefono) {
+        unique_lock<shared_mutex> l(datos_);
+        if (!f_) {
+            en_memoria_.push_back(make_pair(pool_.internar(direccion), pool_.internar(telefono)));
+            return (uint32_t)(en_memoria_.size() - 1);
+        }
+        uint32_t largos[2] = { (uint32_t)direccion.size(), (uint32_t)telefono.size() };
+        cola_.append((const char*)largos, 8);
+        cola_.append(direccion.data(), direccion.size());
+        cola_.append(telefono.data(), telefono.size());
+        desplazamientos_.push_back(fin_);
+        fin_ += 8 + direccion.size() + telefono.size();
+        if (cola_.size() >= TAM_COLA && !fallo_) volcarCola();
+        return (uint32_t)(desplazamientos_.size() - 1);
+    }
+
+    // cachear=false para recorridos completos (snapshot): no desplazan lo que esta en uso.
+    // false si el registro no se pudo leer del archivo (out queda vacio)
+    bool leer(uint32_t ref, Contacto& out, bool cachear = true) const {
+        shared_lock<shared_mutex> l(datos_);
+        if (!f_) {
+            out.direccion.assign(en_memoria_[ref].first.data(), en_memoria_[ref].first.size());
+            out.telefono.assign(en_memoria_[ref].second.data(), en_memoria_[ref].second.size());
+            return true;
+        }
+        TrozoCache& t = cache_[ref % TROZOS_CACHE];
+        {
+            lock_guard<mutex> lt(t.m);
+            unordered_map<uint32_t, ListaLru::iterator>::iterator it = t.indice.find(ref);
+            if (it != t.indice.end()) {
+                ++t.aciertos;
+                t.lru.splice(t.lru.begin(), t.lru, it->second);
+                out = it->second->second;
+                return true;
+            }
+            ++t.fallos;
+        }
+        // la lectura va sin el candado del trozo; los registros no cambian una vez guardados
+        if (!leerRegistro(ref, out)) { fallo_ = true; out = Contacto(); return false; }
+        if (!cachear || capacidad_ == 0) return true;
+        lock_guard<mutex> lt(t.m);
+        if (t.indice.count(ref)) return true; // otro lector lo trajo mientras tanto
+        if (t.lru.size() >= capacidad_) {
+            t.indice.erase(t.lru.back().first);
+            t.lru.splice(t.lru.begin(), t.lru, std::prev(t.lru.end())); // reutiliza el nodo expulsado
+            t.lru.front().first = ref;
+            t.lru.front().second = out;
+        } else {
+            t.lru.push_front(make_pair(ref, out));
+        }
+        t.indice[ref] = t.lru.begin();
+        return true;
+    }
+
+    bool enDisco() const { shared_lock<shared_mutex> l(datos_); return f_ != NULL; }
+    // hubo errores de E/S: al escribir (los registros siguen en memoria) o al leer
+    // (lo supo quien leia)
+    bool fallo() const { return fallo_; }
+    size_t registros() const { shared_lock<shared_mutex> l(datos_); return f_ ? desplazamientos_.size() : en_memoria_.size(); }
+    // lo mismo que PoolCadenas::preparar y soltar, para compactar (en disco no hace falta)
+    void preparar(size_t n) {
+        unique_lock<shared_mutex> l(datos_);
+        if (f_) desplazamientos_.reserve(n);
+        else { en_memoria_.reserve(n); pool_.preparar(2 * n); }
+    }
+    bool soltar(size_t n, bool exclusivo) { unique_lock<shared_mutex> l(datos_); return pool_.soltar(n, exclusivo); }
+    uint64_t bytesEnDisco() const { shared_lock<shared_mutex> l(datos_); return escrito_; }
+    // memoria propia: referencias, pool, cola o cache (aproximado: 64 bytes por entrada de cache)
+    size_t bytesEnMemoria() const {
+        shared_lock<shared_mutex> l(datos_);
+        size_t cache = 0;
+        for (size_t k = 0; k < TROZOS_CACHE; ++k) {
+            lock_guard<mutex> lt(cache_[k].m);
+            for (ListaLru::const_iterator it = cache_[k].lru.begin(); it != cache_[k].lru.end(); ++it)
+                cache += 64 + it->second.direccion.capacity() + it->second.telefono.capacity();
+        }
+        return en_memoria_.capacity() * sizeof(en_memoria_[0]) + pool_.bytesReservados()
+             + desplazamientos_.capacity() * sizeof(uint64_t) + cola_.capacity() + cache;
+    }
+    void contadoresCache(size_t& aciertos, size_t& fallos) const {
+        aciertos = fallos = 0;
+        for (size_t k = 0; k < TROZOS_CACHE; ++k) {
+            lock_guard<mutex> lt(cache_[k].m);
+            aciertos += cache_[k].aciertos;
+            fallos += cache_[k].fallos;
+        }
+    }
+};
+
+
+// ---- motivos de rechazo (para contarlos en las estadisticas) ----
+enum MotivoRechazo {
+    MOTIVO_NINGUNO = 0,
+    MOTIVO_FECHA_INVALIDA,
+    MOTIVO_MENOR_DE_EDAD,
+    MOTIVO_CATEGORIA_INVALIDA,
+    MOTIVO_SALARIO_FUERA_DE_RANGO,
+    MOTIVO_CAMPO_VACIO,
+    MOTIVO_RANGO_FECHAS,
+    MOTIVO_CARNET_DUPLICADO,
+    MOTIVO_CORREO_DUPLICADO,
+    MOTIVO_CODIGO_DUPLICADO,
+    MOTIVO_NOMBRE_DUPLICADO,
+    MOTIVO_NO_ENCONTRADO,
+    MOTIVO_YA_ASIGNADO,
+    MOTIVO_FORMATO,
+    MOTIVO_DIARIO,
+    NUM_MOTIVOS
+};
+
+static const char* const NOMBRES_MOTIVO[NUM_MOTIVOS] = {
+    "ninguno", "fecha_invalida", "menor_de_edad", "categoria_invalida",
+    "salario_fuera_de_rango", "campo_vacio", "rango_fechas", "carnet_duplicado",
+    "correo_duplicado", "codigo_duplicado", "nombre_duplicado", "no_encontrado",
+    "ya_asignado", "formato", "diario"
+};
+
+// error de validacion que ademas dice por que se rechazo el dato
+class ErrorValidacion : public runtime_error {
+private:
+    MotivoRechazo motivo_;
+public:
+    ErrorValidacion(MotivoRechazo motivo, const string& mensaje)
+        : runtime_error(mensaje), motivo_(motivo) {}
+    MotivoRechazo motivo() const { return motivo_; }
+};
+
+// resultado de una validacion sin excepciones: MOTIVO_NINGUNO si el dato paso.
+// El mensaje es un literal, asi que rechazar no reserva memoria.
+struct Validacion {
+    MotivoRechazo motivo;
+    const char* mensaje;
+    Validacion() : motivo(MOTIVO_NINGUNO), mensaje("") {}
+    Validacion(MotivoRechazo m, const char* msg) : motivo(m), mensaje(msg) {}
+    bool ok() const { return motivo == MOTIVO_NINGUNO; }
+};
+
+// puente para los caminos que si reportan con excepciones (constructores y setters)
+static void exigir(const Validacion& v) {
+    if (!v.ok()) throw ErrorValidacion(v.motivo, v.mensaje);
+}
+
+
+enum Categoria {
+    CATEGORIA_ADMINISTRADOR = 0,
+    CATEGORIA_OPERARIO      = 1,
+    CATEGORIA_PEON          = 2
+};
+
+static string categoria_a_texto(Categoria c) {
+    switch (c) {
+        case CATEGORIA_ADMINISTRADOR: return "Administrador";
+        case CATEGORIA_OPERARIO:      return "Operario";
+        case CATEGORIA_PEON:          return "Peon";
+        default:                      return "Desconocida";
+    }
+}
+
+static bool texto_a_categoria(string_view texto, Categoria& out) {
+    string l = a_minusculas(texto);
+    if (l == "administrador") { out = CATEGORIA_ADMINISTRADOR; return true; }
+    if (l == "operario")      { out = CATEGORIA_OPERARIO;      return true; }
+    if (l == "peon")          { out = CATEGORIA_PEON;          return true; }
+    return false;
+}
+
+
+class Empleado {
+private:
+    // calientes: los leen indices, busquedas, asignaciones y nomina
+    enum { CARNET = 0, NOMBRE, CORREO, NUM_TEXTOS };
+    CamposTexto<NUM_TEXTOS> textos_;
+    // frios: propios mientras el empleado esta suelto; en el AlmacenFrio del gestor
+    // una vez archivado (entonces contacto_ es nulo)
+    enum { DIRECCION = 0, TELEFONO, NUM_CONTACTO };
+    unique_ptr<CamposTexto<NUM_CONTACTO> > contacto_;
+    const AlmacenFrio* frio_;
+    uint32_t ref_frio_;
+    Fecha fecha_nacimiento_;
+    Categoria categoria_;
+    double salario_;
+
+    void fijar_textos(string_view carnet, string_view nombre, string_view direccion,
+                      string_view telefono, string_view correo) {
+        string_view v[NUM_TEXTOS] = { carnet, nombre, correo };
+        textos_.fijar(v);
+        string_view c[NUM_CONTACTO] = { direccion.empty() ? string_view("San Jose") : direccion, telefono };
+        contacto_.reset(new CamposTexto<NUM_CONTACTO>());
+        contacto_->fijar(c);
+        frio_ = NULL;
+        ref_frio_ = 0;
+    }
+    // los campos frios vuelven a ser propios (para modificarlos); false si el almacen
+    // no los pudo leer: entonces el empleado queda como estaba
+    bool contactoPropio() {
+        if (!contacto_) {
+            AlmacenFrio::Contacto c;
+            if (!contacto(c)) return false;
+            string_view v[NUM_CONTACTO] = { c.direccion, c.telefono };
+            contacto_.reset(new CamposTexto<NUM_CONTACTO>());
+            contacto_->fijar(v);
+            frio_ = NULL;
+        }
+        return true;
+    }
+    void copiar(const Empleado& o) {
+        textos_ = o.textos_;
+        contacto_.reset(o.contacto_ ? new CamposTexto<NUM_CONTACTO>(*o.contacto_) : NULL);
+        frio_ = o.frio_;
+        ref_frio_ = o.ref_frio_;
+        fecha_nacimiento_ = o.fecha_nacimiento_;
+        categoria_ = o.categoria_;
+        salario_ = o.salario_;
+    }
+
+public:
+    // ---- validaciones sin excepciones (las comparten constructores, setters y el gestor) ----
+    static Validacion validarFechaNacimiento(const string& f, Fecha hoy, Fecha& nac) {
+        if (!Fecha::parsear(f, nac))
+            return Validacion(MOTIVO_FECHA_INVALIDA, "Fecha de nacimiento invalida (use YYYY-MM-DD).");
+        return validarNacimiento(nac, hoy);
+    }
+    static Validacion validarNacimiento(Fecha nac, Fecha hoy) {
+        if (nac > hoy)
+            return Validacion(MOTIVO_FECHA_INVALIDA, "Fecha de nacimiento invalida (use YYYY-MM-DD).");
+        if (calcular_edad(nac, hoy) < 18)
+            return Validacion(MOTIVO_MENOR_DE_EDAD, "No se pueden contratar menores de edad.");
+        return Validacion();
+    }
+    static Validacion validarCategoria(string_view texto, Categoria& c) {
+        if (!texto_a_categoria(texto, c))
+            return Validacion(MOTIVO_CATEGORIA_INVALIDA, "Categoria invalida. Use: Administrador, Operario o Peon.");
+        return Validacion();
+    }
+    static Validacion validarSalario(double s) {
+        if (!(s >= 250000.0 && s <= 500000.0)) // tambien NaN (de disco)
+            return Validacion(MOTIVO_SALARIO_FUERA_DE_RANGO, "El salario debe estar entre 250000 y 500000.");
+        return Validacion();
+    }
+    // la unicidad del correo la controla GestorSistema (RegistroUnico)
+    static Validacion validarCorreo(string_view c) {
+        if (c.empty()) return Validacion(MOTIVO_CAMPO_VACIO, "El correo no puede estar vacio.");
+        return Validacion();
+    }
+    // todos los campos de un alta, en el orden en que los revisan los constructores;
+    // deja en 'nac' y 'cat' los valores ya interpretados
+    static Validacion validar(const string& fecha_nacimiento, string_view categoria_texto,
+                              double salario, string_view correo, Fecha hoy,
+                              Fecha& nac, Categoria& cat)
+    {
+        Validacion v = validarFechaNacimiento(fecha_nacimiento, hoy, nac);
+        if (v.ok()) v = validarCategoria(categoria_texto, cat);
+        if (v.ok()) v = validarSalario(salario);
+        if (v.ok()) v = validarCorreo(correo);
+        return v;
+    }
+    // lo mismo para un empleado leido de disco (snapshot o diario), con la fecha ya
+    // interpretada; la categoria la revisa quien lee el numero
+    static Validacion validarRestaurado(Fecha nac, double salario, string_view correo, Fecha hoy) {
+        Validacion v = validarNacimiento(nac, hoy);
+        if (v.ok()) v = validarSalario(salario);
+        if (v.ok()) v = validarCorreo(correo);
+        return v;
+    }
+
+    // empleado con campos ya validados (validar(), snapshot o diario): no revisa nada
+    Empleado(string_view carnet, string_view nombre, Fecha fecha_nacimiento,
+             Categoria categoria, double salario, string_view direccion,
+             string_view telefono, string_view correo)
+        : fecha_nacimiento_(fecha_nacimiento), categoria_(categoria), salario_(salario)
+    {
+        fijar_textos(carnet, nombre, direccion, telefono, correo);
+    }
+
+    // reconstruye un empleado ya validado (snapshot / diario en disco)
+    static Empleado restaurar(const string& carnet, const string& nombre,
+                              Fecha fecha_nacimiento, Categoria categoria,
+                              double salario, const string& direccion,
+                              const string& telefono, const string& correo)
+    {
+        Empleado e(carnet, nombre, fecha_nacimiento, categoria, salario, direccion, telefono, correo);
+        if (direccion.empty()) e.contacto_->set(DIRECCION, string_view()); // tal cual, sin el valor por defecto
+        return e;
+    }
+
+    Empleado(const Empleado& o) { copiar(o); }
+    Empleado(Empleado&&) noexcept = default;
+    Empleado& operator=(const Empleado& o) { if (this != &o) copiar(o); return *this; }
+    Empleado& operator=(Empleado&&) noexcept = default;
+
+    // constructor sin salario: asigna 250000 por defecto
+    // (hoy: fecha de referencia para la edad; los lotes la calculan una sola vez)
+    Empleado(const string& carnet,
+             const string& nombre,
+             const string& fecha_nacimiento,
+             const string& categoria_texto,
+             const string& direccion,
+             const string& telefono,
+             const string& correo,
+             Fecha hoy = Fecha::hoy())
+        : fecha_nacimiento_(), categoria_(CATEGORIA_OPERARIO), salario_(250000.0)
+    {
+        exigir(validar(fecha_nacimiento, categoria_texto, salario_, correo, hoy, fecha_nacimiento_, categoria_));
+        fijar_textos(carnet, nombre, direccion, telefono, correo);
+    }
+
+    // constructor con salario
+    Empleado(const string& carnet,
+             const string& nombre,
+             const string& fecha_nacimiento,
+             const string& categoria_texto,
+             double salario,
+             const string& direccion,
+             const string& telefono,
+             const string& correo,
+             Fecha hoy = Fecha::hoy())
+        : fecha_nacimiento_(), categoria_(CATEGORIA_OPERARIO), salario_(salario)
+    {
+        exigir(validar(fecha_nacimiento, categoria_texto, salario, correo, hoy, fecha_nacimiento_, categoria_));
+        fijar_textos(carnet, nombre, direccion, telefono, correo);
+    }
+
+    // pasa los textos calientes al pool del gestor (libera el buffer propio)
+    void internar(PoolCadenas& pool) { textos_.internar(pool); }
+    // pasa los campos frios al almacen del gestor (que debe vivir mas que el empleado)
+    void archivar(AlmacenFrio& frio) {
+        if (!contacto_) return;
+        ref_frio_ = frio.guardar(contacto_->get(DIRECCION), contacto_->get(TELEFONO));
+        frio_ = &frio;
+        contacto_.reset();
+    }
+    // ya archivado: el registro se copio a otro almacen (compactacion) con la referencia 'ref'
+    bool archivadoEn(const AlmacenFrio& frio) const { return frio_ == &frio; }
+    void reubicar(const AlmacenFrio& frio, uint32_t ref) {
+        frio_ = &frio;
+        ref_frio_ = ref;
+        contacto_.reset();
+    }
+
+    // getters
+    string_view getCarnet() const { return textos_.get(CARNET); }
+    string_view getNombre() const { return textos_.get(NOMBRE); }
+    Fecha getFechaNacimiento() const { return fecha_nacimiento_; }
+    Categoria getCategoria() const { return categoria_; }
+    double getSalario() const { return salario_; }
+    string_view getCorreo() const { return textos_.get(CORREO); }
+    // los frios se devuelven por copia: en disco pueden salir de la cache en cualquier momento.
+    // false si el almacen no pudo leerlos; un empleado ya movido no tiene ninguno
+    bool contacto(AlmacenFrio::Contacto& out, bool cachear = true) const {
+        if (frio_) return frio_->leer(ref_frio_, out, cachear);
+        if (!contacto_) { out = AlmacenFrio::Contacto(); return true; }
+        out.direccion.assign(contacto_->get(DIRECCION).data(), contacto_->get(DIRECCION).size());
+        out.telefono.assign(contacto_->get(TELEFONO).data(), contacto_->get(TELEFONO).size());
+        return true;
+    }
+    // atajos para empleados sueltos (diario); vacios si el almacen no pudo leer
+    string getDireccion() const { AlmacenFrio::Contacto c; contacto(c); return c.direccion; }
+    string getTelefono() const { AlmacenFrio::Contacto c; contacto(c); return c.telefono; }
+
+    // setters (los de texto dejan el objeto con buffer propio hasta volver a internarlo)
+    void setNombre(const string& n) { textos_.set(NOMBRE, n); }
+    void setFechaNacimiento(const string& f, Fecha hoy = Fecha::hoy()) {
+        Fecha nac;
+        exigir(validarFechaNacimiento(f, hoy, nac));
+        fecha_nacimiento_ = nac;
+    }
+    void setCategoria(const string& c) { exigir(validarCategoria(c, categoria_)); }
+    void setCategoria(Categoria c) { categoria_ = c; }
+    void setSalario(double s) { exigir(validarSalario(s)); salario_ = s; }
+    bool setDireccion(const string& d) {
+        if (!contactoPropio()) return false;
+        contacto_->set(DIRECCION, d.empty() ? string_view("San Jose") : string_view(d));
+        return true;
+    }
+    bool setTelefono(const string& t) {
+        if (!contactoPropio()) return false;
+        contacto_->set(TELEFONO, t);
+        return true;
+    }
+    void setCorreo(const string& c) { exigir(validarCorreo(c)); textos_.set(CORREO, c); }
+
+    // mostrar info completa (hoy: referencia para la edad, calculada una vez por listado)
+    void mostrar(BufferSalida& os, Fecha hoy) const {
+        os << "Carnet: " << getCarnet() << "\n";
+        os << "Nombre: " << getNombre() << "\n";
+        os << "Fecha de nacimiento: " << fecha_nacimiento_
+           << " (edad aprox: " << calcular_edad(fecha_nacimiento_, hoy) << ")\n";
+        os << "Categoria: " << categoria_a_texto(categoria_) << "\n";
+        os << "Salario: " << salario_ << "\n";
+        AlmacenFrio::Contacto c;
+        if (contacto(c)) {
+            os << "Direccion: " << c.direccion << "\n";
+            os << "Telefono: " << c.telefono << "\n";
+        } else {
+            os << "Direccion: (no se pudo leer del almacen frio)\n";
+            os << "Telefono: (no se pudo leer del almacen frio)\n";
+        }
+        os << "Correo: " << getCorreo() << "\n";
+    }
+    void mostrar(ostream& os, Fecha hoy) const { BufferSalida b(&os); mostrar(b, hoy); }
+    void mostrar(ostream& os) const { mostrar(os, Fecha::hoy()); }
+};
+
+
+class Proyecto {
+private:
+    enum { CODIGO = 0, NOMBRE, NUM_TEXTOS };
+    CamposTexto<NUM_TEXTOS> textos_;
+    Fecha fecha_inicio_;
+    Fecha fecha_finalizacion_;
+
+    void fijar_textos(string_view codigo, string_view nombre) {
+        string_view v[NUM_TEXTOS] = { codigo, nombre };
+        textos_.fijar(v);
+    }
+    static Validacion validarInicio(const string& f, Fecha& r) {
+        if (!Fecha::parsear(f, r)) return Validacion(MOTIVO_FECHA_INVALIDA, "Fecha de inicio invalida (use YYYY-MM-DD).");
+        return Validacion();
+    }
+    static Validacion validarFin(const string& f, Fecha& r) {
+        if (!Fecha::parsear(f, r)) return Validacion(MOTIVO_FECHA_INVALIDA, "Fecha de finalizacion invalida (use YYYY-MM-DD).");
+        return Validacion();
+    }
+
+public:
+    // ---- validaciones sin excepciones (las comparten constructores, setters y el gestor) ----
+    // la unicidad del nombre la controla GestorSistema (RegistroUnico)
+    static Validacion validarNombre(string_view n) {
+        if (n.empty()) return Validacion(MOTIVO_CAMPO_VACIO, "El nombre del proyecto no puede estar vacio.");
+        return Validacion();
+    }
+    static Validacion validarRango(Fecha inicio, Fecha fin) {
+        if (fin < inicio)
+            return Validacion(MOTIVO_RANGO_FECHAS, "La fecha de finalizacion no puede ser anterior a la de inicio.");
+        return Validacion();
+    }
+    // todos los campos de un alta; deja las fechas interpretadas en 'ini' y 'fin'
+    static Validacion validar(string_view nombre, const string& fecha_inicio, const string& fecha_fin,
+                              Fecha& ini, Fecha& fin)
+    {
+        Validacion v = validarNombre(nombre);
+        if (v.ok()) v = validarInicio(fecha_inicio, ini);
+        if (v.ok()) v = validarFin(fecha_fin, fin);
+        if (v.ok()) v = validarRango(ini, fin);
+        return v;
+    }
+
+    Proyecto(const string& codigo, const string& nombre,
+             const string& fecha_inicio, const string& fecha_fin)
+    {
+        exigir(validar(nombre, fecha_inicio, fecha_fin, fecha_inicio_, fecha_finalizacion_));
+        fijar_textos(codigo, nombre);
+    }
+    Proyecto(string_view codigo, string_view nombre, Fecha fecha_inicio, Fecha fecha_fin)
+        : fecha_inicio_(fecha_inicio), fecha_finalizacion_(fecha_fin)
+    {
+        exigir(validarNombre(nombre));
+        exigir(validarRango(fecha_inicio, fecha_fin));
+        fijar_textos(codigo, nombre);
+    }
+
+    // pasa los textos al pool del gestor (libera el buffer propio)
+    void internar(PoolCadenas& pool) { textos_.internar(pool); }
+
+    // getters
+    string_view getCodigo() const { return textos_.get(CODIGO); }
+    string_view getNombre() const { return textos_.get(NOMBRE); }
+    Fecha getFechaInicio() const { return fecha_inicio_; }
+    Fecha getFechaFinalizacion() const { return fecha_finalizacion_; }
+
+    // setters
+    void setNombre(const string& n) { exigir(validarNombre(n)); textos_.set(NOMBRE, n); }
+    void setFechaInicio(const string& f) {
+        Fecha ini;
+        exigir(validarInicio(f, ini));
+        exigir(validarRango(ini, fecha_finalizacion_));
+        fecha_inicio_ = ini;
+    }
+    void setFechaFinalizacion(const string& f) {
+        Fecha fin;
+        exigir(validarFin(f, fin));
+        exigir(validarRango(fecha_inicio_, fin));
+        fecha_finalizacion_ = fin;
+    }
+
+    // mostrar
+    void mostrar(BufferSalida& os) const {
+        os << "Codigo: " << getCodigo() << "\n";
+        os << "Nombre: " << getNombre() << "\n";
+        os << "Fecha de inicio: " << fecha_inicio_ << "\n";
+        os << "Fecha de finalizacion: " << fecha_finalizacion_ << "\n";
+    }
+    void mostrar(ostream& os) const { BufferSalida b(&os); mostrar(b); }
+};
+
+
+// registro de valores unicos (en minusculas) propio de cada GestorSistema
+// (guarda vistas: lo registrado debe vivir en el PoolCadenas del gestor)
+class RegistroUnico {
+private:
+    unordered_set<string_view> valores_;
+
+public:
+    bool existe(string_view low) const { return valores_.count(low) != 0; }
+    bool registrar(string_view low) { return valores_.insert(low).second; }
+    void liberar(string_view low) { valores_.erase(low); }
+    // el mismo valor, guardado ahora en 'low' (al mover los textos a otro pool)
+    void reapuntar(string_view low) {
+        unordered_set<string_view>::node_type n = valores_.extract(low);
+        if (n.empty()) return;
+        n.value() = low;
+        valores_.insert(std::move(n));
+    }
+    size_t size() const { return valores_.size(); }
+};
+
+
+// ---- importacion masiva (CSV / JSONL) ----
+enum TipoImportacion {
+    IMPORTAR_EMPLEADOS    = 0,
+    IMPORTAR_PROYECTOS    = 1,
+    IMPORTAR_ASIGNACIONES = 2
+};
+
+struct ErrorImportacion {
+    size_t linea;
+    string mensaje;
+    MotivoRechazo motivo;
+    ErrorImportacion() : linea(0), motivo(MOTIVO_FORMATO) {}
+};
+
+struct ReporteImportacion {
+    size_t leidas;
+    size_t aceptadas;
+    vector<ErrorImportacion> errores; // ordenados por linea
+    ReporteImportacion() : leidas(0), aceptadas(0) {}
+};
+
+// columnas canonicas por tipo (nombres de cabecera CSV o llaves JSON)
+static const char* const COLUMNAS_EMPLEADO[] = {
+    "carnet", "nombre", "fecha_nacimiento", "categoria",
+    "salario", "direccion", "telefono", "correo"
+};
+static const char* const COLUMNAS_PROYECTO[] = {
+    "codigo", "nombre", "fecha_inicio", "fecha_finalizacion"
+};
+static const char* const COLUMNAS_ASIGNACION[] = {
+    "carnet", "codigo", "fecha_asignacion"
+};
+
+static size_t columnas_de(TipoImportacion t, const char* const*& nombres) {
+    switch (t) {
+        case IMPORTAR_EMPLEADOS: nombres = COLUMNAS_EMPLEADO; return 8;
+        case IMPORTAR_PROYECTOS: nombres = COLUMNAS_PROYECTO; return 4;
+        default:                 nombres = COLUMNAS_ASIGNACION; return 3;
+    }
+}
+
+static int columna_canonica(TipoImportacion t, const string& nombre) {
+    const char* const* nombres;
+    size_t n = columnas_de(t, nombres);
+    string l = a_minusculas(nombre);
+    for (size_t i = 0; i < n; ++i)
+        if (l == nombres[i]) return (int)i;
+    return -1;
+}
+
+// separa una linea CSV (comillas dobles, "" como escape); false si queda una comilla abierta
+static bool separar_csv(const string& linea, vector<string>& campos) {
+    campos.clear();
+    string actual;
+    bool comillas = false;
+    for (size_t i = 0; i < linea.size(); ++i) {
+        char c = linea[i];
+        if (comillas) {
+            if (c == '"') {
+                if (i + 1 < linea.size() && linea[i + 1] == '"') { actual += '"'; ++i; }
+                else comillas = false;
+            } else actual += c;
+        }
+        else if (c == '"') comillas = true;
+        else if (c == ',') { campos.push_back(actual); actual.clear(); }
+        else actual += c;
+    }
+    campos.push_back(actual);
+    return !comillas;
+}
+
+static void saltar_espacios(const string& s, size_t& i) {
+    while (i < s.size() && isspace((unsigned char)s[i])) ++i;
+}
+
+static void agregar_utf8(string& out, unsigned cp) {
+    if (cp < 0x80) out += (char)cp;
+    else if (cp < 0x800) { out += (char)(0xC0 | (cp >> 6)); out += (char)(0x80 | (cp & 0x3F)); }
+    else {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+static bool leer_cadena_json(const string& s, size_t& i, string& out) {
+    if (i >= s.size() || s[i] != '"') return false;
+    ++i;
+    out.clear();
+    while (i < s.size()) {
+        char c = s[i++];
+        if (c == '"') return true;
+        if (c != '\\') { out += c; continue; }
+        if (i >= s.size()) return false;
+        char e = s[i++];
+        switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (i + 4 > s.size()) return false;
+                unsigned cp = 0;
+                for (int k = 0; k < 4; ++k) {
+                    char h = s[i++];
+                    cp <<= 4;
+                    if (h >= '0' && h <= '9') cp |= (unsigned)(h - '0');
+                    else if (h >= 'a' && h <= 'f') cp |= (unsigned)(h - 'a' + 10);
+                    else if (h >= 'A' && h <= 'F') cp |= (unsigned)(h - 'A' + 10);
+                    else return false;
+                }
+                agregar_utf8(out, cp);
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+// objeto JSON plano de una linea: {"llave": "texto" | numero | true | false | null, ...}
+static bool parsear_objeto_json(const string& s, vector<pair<string, string> >& pares, string& error) {
+    pares.clear();
+    size_t i = 0;
+    saltar_espacios(s, i);
+    if (i >= s.size() || s[i] != '{') { error = "JSON invalido: se esperaba '{'."; return false; }
+    ++i;
+    saltar_espacios(s, i);
+    if (i < s.size() && s[i] == '}') return true;
+    while (true) {
+        string llave, valor;
+        saltar_espacios(s, i);
+        if (!leer_cadena_json(s, i, llave)) { error = "JSON invalido: llave mal formada."; return false; }
+        saltar_espacios(s, i);
+        if (i >= s.size() || s[i] != ':') { error = "JSON invalido: se esperaba ':'."; return false; }
+        ++i;
+        saltar_espacios(s, i);
+        if (i < s.size() && s[i] == '"') {
+            if (!leer_cadena_json(s, i, valor)) { error = "JSON invalido: texto mal formado."; return false; }
+        } else {
+            size_t ini = i;
+            while (i < s.size() && s[i] != ',' && s[i] != '}' && !isspace((unsigned char)s[i])) ++i;
+            valor = s.substr(ini, i - ini);
+            if (valor.empty() || valor[0] == '{' || valor[0] == '[') {
+                error = "JSON invalido: solo se admiten valores simples."; return false;
+            }
+            if (valor == "null") valor.clear();
+        }
+        pares.push_back(make_pair(llave, valor));
+        saltar_espacios(s, i);
+        if (i < s.size() && s[i] == ',') { ++i; continue; }
+        if (i < s.size() && s[i] == '}') break;
+        error = "JSON invalido: se esperaba ',' o '}'.";
+        return false;
+    }
+    return true;
+}
+
+// resultado de validar un tramo de lineas en un hilo de trabajo
+struct LoteValidado {
+    vector<Empleado> empleados;
+    vector<Proyecto> proyectos;
+    vector<vector<string> > asignaciones; // carnet, codigo, fecha_asignacion
+    vector<size_t> lineas;                // linea de cada registro valido
+    vector<ErrorImportacion> errores;
+};
+
+// parseo y validaciones por registro (sin unicidad); no toca estado compartido
+static void validar_tramo(TipoImportacion tipo, bool jsonl, const vector<int>& mapa_csv,
+                          const vector<string>& lineas, const vector<size_t>& numeros,
+                          size_t desde, size_t hasta, Fecha hoy, LoteValidado& out)
+{
+    const char* const* nombres;
+    size_t ncol = columnas_de(tipo, nombres);
+    vector<string> crudos;
+    vector<pair<string, string> > pares;
+    vector<string> c(ncol);
+
+    for (size_t i = desde; i < hasta; ++i) {
+        ErrorImportacion err;
+        err.linea = numeros[i];
+        for (size_t k = 0; k < ncol; ++k) c[k].clear();
+
+        if (jsonl) {
+            if (!parsear_objeto_json(lineas[i], pares, err.mensaje)) { out.errores.push_back(err); continue; }
+            for (size_t k = 0; k < pares.size(); ++k) {
+                int col = columna_canonica(tipo, pares[k].first);
+                if (col >= 0) c[col] = pares[k].second;
+            }
+        } else {
+            if (!separar_csv(lineas[i], crudos)) {
+                err.mensaje = "CSV invalido: comilla sin cerrar.";
+                out.errores.push_back(err);
+                continue;
+            }
+            for (size_t k = 0; k < crudos.size() && k < mapa_csv.size(); ++k)
+                if (mapa_csv[k] >= 0) c[mapa_csv[k]] = crudos[k];
+        }
+
+        // sin excepciones: con muchos rechazos el costo seria desenrollar la pila
+        Validacion v;
+        if (tipo == IMPORTAR_EMPLEADOS) {
+            double sal = 250000.0;
+            Fecha nac;
+            Categoria cat;
+            if (c[0].empty()) {
+                v = Validacion(MOTIVO_CAMPO_VACIO, "El carnet no puede estar vacio.");
+            } else if (!c[4].empty()) {
+                char* fin = NULL;
+                sal = std::strtod(c[4].c_str(), &fin);
+                if (fin == c[4].c_str() || *fin != '\0') v = Validacion(MOTIVO_FORMATO, "Salario invalido.");
+            }
+            if (v.ok()) v = Empleado::validar(c[2], c[3], sal, c[7], hoy, nac, cat);
+            if (v.ok()) out.empleados.emplace_back(c[0], c[1], nac, cat, sal, c[5], c[6], c[7]);
+        }
+        else if (tipo == IMPORTAR_PROYECTOS) {
+            Fecha ini, fin;
+            if (c[0].empty()) v = Validacion(MOTIVO_CAMPO_VACIO, "El codigo no puede estar vacio.");
+            else v = Proyecto::validar(c[1], c[2], c[3], ini, fin);
+            if (v.ok()) out.proyectos.emplace_back(c[0], c[1], ini, fin);
+        }
+        else {
+            Fecha f;
+            if (c[0].empty() || c[1].empty())
+                v = Validacion(MOTIVO_CAMPO_VACIO, "Carnet y codigo son obligatorios.");
+            else if (!c[2].empty() && !Fecha::parsear(c[2], f))
+                v = Validacion(MOTIVO_FECHA_INVALIDA, "Fecha de asignacion invalida (use YYYY-MM-DD).");
+            if (v.ok()) out.asignaciones.push_back(c);
+        }
+        if (v.ok()) {
+            out.lineas.push_back(numeros[i]);
+        } else {
+            err.mensaje = v.mensaje;
+            err.motivo = v.motivo;
+            out.errores.push_back(err);
+        }
+    }
+}
+
+// ---- exportacion masiva (CSV / JSONL) ----
+enum TipoExportacion {
+    EXPORTAR_EMPLEADOS    = 0,
+    EXPORTAR_PROYECTOS    = 1,
+    EXPORTAR_ASIGNACIONES = 2
+};
+
+// empleados y proyectos salen con las columnas de importacion (el archivo se puede
+// volver a importar); las asignaciones como vista unida, que importar() tambien
+// acepta porque ignora las columnas que no conoce
+static const char* const COLUMNAS_ASIGNACION_EXPORTADA[] = {
+    "carnet", "nombre", "categoria", "codigo", "proyecto", "fecha_asignacion"
+};
+
+static size_t columnas_exportadas(TipoExportacion t, const char* const*& nombres) {
+    switch (t) {
+        case EXPORTAR_EMPLEADOS: nombres = COLUMNAS_EMPLEADO; return 8;
+        case EXPORTAR_PROYECTOS: nombres = COLUMNAS_PROYECTO; return 4;
+        default:                 nombres = COLUMNAS_ASIGNACION_EXPORTADA; return 6;
+    }
+}
+
+struct ReporteExportacion {
+    size_t filas;
+    uint64_t bytes;
+    ReporteExportacion() : filas(0), bytes(0) {}
+};
+
+// arma una fila en 'out': CSV con comillas solo donde hacen falta, o un objeto JSON
+// por linea con las columnas como llaves (lo que leen separar_csv y parsear_objeto_json)
+class FilaExportada {
+private:
+    string& out_;
+    bool jsonl_;
+    const char* const* columnas_;
+    int k_;
+
+    void separador() {
+        if (jsonl_) {
+            out_ += k_ == 0 ? "{\"" : ",\"";
+            out_ += columnas_[k_];
+            out_ += "\":";
+        } else if (k_ > 0) {
+            out_ += ',';
+        }
+        ++k_;
+    }
+
+public:
+    FilaExportada(string& out, bool jsonl, const char* const* columnas)
+        : out_(out), jsonl_(jsonl), columnas_(columnas), k_(0) {}
+
+    void texto(string_view v) {
+        separador();
+        if (jsonl_) {
+            out_ += '"';
+            size_t limpio = 0; // inicio del tramo que no necesita escape (se copia de una vez)
+            for (size_t i = 0; i < v.size(); ++i) {
+                unsigned char c = (unsigned char)v[i];
+                if (c >= 0x20 && c != '"' && c != '\\') continue;
+                out_.append(v.data() + limpio, i - limpio);
+                limpio = i + 1;
+                if (c == '"' || c == '\\') { out_ += '\\'; out_ += (char)c; }
+                else if (c == '\n') out_ += "\\n";
+                else if (c == '\r') out_ += "\\r";
+                else if (c == '\t') out_ += "\\t";
+                else {
+                    static const char hex[] = "0123456789abcdef";
+                    out_ += "\\u00";
+                    out_ += hex[c >> 4];
+                    out_ += hex[c & 15];
+                }
+            }
+            out_.append(v.data() + limpio, v.size() - limpio);
+            out_ += '"';
+            return;
+        }
+        if (v.find_first_of(",\"\r\n") == string_view::npos) { out_.append(v.data(), v.size()); return; }
+        out_ += '"';
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (v[i] == '"') out_ += '"';
+            out_ += v[i];
+        }
+        out_ += '"';
+    }
+    void fecha(Fecha f) {
+        char buf[10];
+        f.escribir(buf);
+        texto(string_view(buf, 10));
+    }
+    // la representacion fija mas corta que se vuelve a leer igual (300000, 312345.5);
+    // si no cabe (montos absurdos) se cae a la forma cientifica
+    void numero(double v) {
+        separador();
+        char buf[64];
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::fixed);
+        if (r.ec != std::errc()) r = std::to_chars(buf, buf + sizeof(buf), v);
+        out_.append(buf, r.ptr - buf);
+    }
+    void terminar() { out_ += jsonl_ ? "}\n" : "\n"; }
+};
+
+
+// ---- persistencia binaria: snapshot mapeable + diario de escritura anticipada ----
+static uint32_t fnv1a(const char* p, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i) { h ^= (unsigned char)p[i]; h *= 16777619u; }
+    return h;
+}
+
+static void poner_u32(vector<char>& b, uint32_t v) { b.insert(b.end(), (const char*)&v, (const char*)&v + 4); }
+static void poner_f64(vector<char>& b, double v) { b.insert(b.end(), (const char*)&v, (const char*)&v + 8); }
+static void poner_cadena(vector<char>& b, string_view s) {
+    poner_u32(b, (uint32_t)s.size());
+    b.insert(b.end(), s.begin(), s.end());
+}
+
+// lectura acotada de un bloque binario; ok() queda en false al salirse del bloque
+class LectorBinario {
+private:
+    const char* p_;
+    size_t n_;
+    size_t pos_;
+    bool ok_;
+
+public:
+    LectorBinario(const char* p, size_t n) : p_(p), n_(n), pos_(0), ok_(true) {}
+    bool ok() const { return ok_; }
+    size_t pos() const { return pos_; }
+    bool fin() const { return pos_ >= n_; }
+    void saltar(size_t k) { if (n_ - pos_ < k) ok_ = false; else pos_ += k; }
+    bool bytes(void* dst, size_t k) {
+        if (!ok_ || n_ - pos_ < k) { ok_ = false; return false; }
+        std::memcpy(dst, p_ + pos_, k);
+        pos_ += k;
+        return true;
+    }
+    uint32_t u32() { uint32_t v = 0; bytes(&v, 4); return v; }
+    double f64() { double v = 0; bytes(&v, 8); return v; }
+    string cadena() {
+        uint32_t len = u32();
+        if (!ok_ || n_ - pos_ < len) { ok_ = false; return string(); }
+        string s(p_ + pos_, len);
+        pos_ += len;
+        return s;
+    }
+};
+
+// archivo de solo lectura mapeado en memoria (copia en memoria en Windows)
+class ArchivoMapeado {
+private:
+    const char* datos_;
+    size_t tam_;
+#ifdef _WIN32
+    vector<char> copia_;
+#endif
+
+public:
+    ArchivoMapeado() : datos_(NULL), tam_(0) {}
+    ~ArchivoMapeado() { cerrar(); }
+
+    bool abrir(const string& ruta) {
+        cerrar();
+#ifdef _WIN32
+        ifstream in(ruta.c_str(), ios::in | ios::binary);
+        if (!in) return false;
+        copia_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        datos_ = copia_.empty() ? "" : &copia_[0];
+        tam_ = copia_.size();
+        return true;
+#else
+        int fd = ::open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+        tam_ = (size_t)st.st_size;
+        if (tam_ == 0) { ::close(fd); datos_ = ""; return true; }
+        void* m = mmap(NULL, tam_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED) { tam_ = 0; return false; }
+        madvise(m, tam_, MADV_SEQUENTIAL);
+        datos_ = (const char*)m;
+        return true;
+#endif
+    }
+    void cerrar() {
+#ifndef _WIN32
+        if (datos_ && tam_ > 0) munmap((void*)datos_, tam_);
+#else
+        copia_.clear();
+#endif
+        datos_ = NULL;
+        tam_ = 0;
+    }
+    const char* datos() const { return datos_; }
+    size_t tam() const { return tam_; }
+};
+
+static bool sincronizar_archivo(FILE* f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+static bool crear_directorio(const string& ruta) {
+#ifdef _WIN32
+    return _mkdir(ruta.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(ruta.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+static bool reemplazar_archivo(const string& origen, const string& destino) {
+#ifdef _WIN32
+    std::remove(destino.c_str());
+#endif
+    return std::rename(origen.c_str(), destino.c_str()) == 0;
+}
+
+// formato del snapshot (nativo, little-endian en x86/ARM):
+//   cabecera | tabla de cadenas [u32 largo][bytes]... | registros de ancho fijo
+// los registros guardan el desplazamiento de cada cadena dentro de la tabla
+struct CabeceraSnapshot {
+    char magia[4];           // "GSNP"
+    uint32_t version;
+    uint64_t n_empleados;
+    uint64_t n_proyectos;
+    uint64_t n_asignaciones;
+    uint64_t off_cadenas;
+    uint64_t tam_cadenas;
+    uint64_t off_empleados;
+    uint64_t off_proyectos;
+    uint64_t off_asignaciones;
+};
+struct EmpleadoDisco {
+    uint32_t carnet, nombre, direccion, telefono, correo;
+    int32_t fecha_nacimiento; // dias desde 1970-01-01
+    uint32_t categoria;
+    uint32_t reservado;
+    double salario;
+};
+struct ProyectoDisco {
+    uint32_t codigo, nombre;
+    int32_t fecha_inicio, fecha_finalizacion;
+};
+struct AsignacionDisco {
+    uint32_t empleado, proyecto;
+    int32_t fecha;
+    uint32_t reservado;
+};
+static const uint32_t VERSION_SNAPSHOT = 2;
+
+// tipos de registro del diario
+enum TipoDiario {
+    DIARIO_EMPLEADO       = 1,
+    DIARIO_PROYECTO       = 2,
+    DIARIO_ASIGNACION     = 3,
+    DIARIO_CORREO         = 4,
+    DIARIO_NOMBRE_PROYECTO = 5,
+    DIARIO_SALARIO        = 6,
+    DIARIO_CATEGORIA      = 7,
+    DIARIO_BAJA_EMPLEADO  = 8, // las asignaciones del empleado se quitan en cascada
+    DIARIO_BAJA_PROYECTO  = 9, // idem con las del proyecto
+    DIARIO_BAJA_ASIGNACION = 10
+};
+
+// diario de solo-anexar: [u32 largo][u8 tipo][carga][u32 fnv1a(tipo+carga)]
+// un registro incompleto al final (caida a media escritura) se descarta al reproducir
+class Diario {
+private:
+    FILE* f_;
+    string ruta_;
+    atomic<size_t> entradas_; // se consulta sin el candado del gestor
+    atomic<bool> fallo_;      // error de escritura; queda puesto hasta reiniciar
+    int agrupando_;
+    vector<char> buf_;
+
+    void escribir() {
+        // tras un error no se escribe mas: lo que siguiera a un registro roto no se reproduce
+        if (fallo_) return;
+        // buf_ contiene [tipo][carga]; se antepone largo y se agrega checksum
+        uint32_t largo = (uint32_t)buf_.size();
+        uint32_t suma = fnv1a(&buf_[0], buf_.size());
+        bool ok = fwrite(&largo, 4, 1, f_) == 1 &&
+                  fwrite(&buf_[0], 1, buf_.size(), f_) == buf_.size() &&
+                  fwrite(&suma, 4, 1, f_) == 1;
+        if (ok && agrupando_ == 0) ok = fflush(f_) == 0;
+        if (ok) ++entradas_;
+        else fallo_ = true;
+    }
+    void iniciar(TipoDiario tipo) { buf_.clear(); buf_.push_back((char)tipo); }
+    void reabrir() { if (!abrir(ruta_)) fallo_ = true; }
+
+    static bool anexar(FILE* src, FILE* dst) {
+        char bloque[1 << 16];
+        size_t n;
+        while ((n = fread(bloque, 1, sizeof(bloque), src)) > 0)
+            if (fwrite(bloque, 1, n, dst) != n) return false;
+        return !ferror(src);
+    }
+
+public:
+    Diario() : f_(NULL), entradas_(0), fallo_(false), agrupando_(0) {}
+    ~Diario() { cerrar(); }
+
+    bool abrir(const string& ruta) {
+        cerrar();
+        ruta_ = ruta;
+        f_ = fopen(ruta.c_str(), "ab");
+        if (!f_) return false;
+        setvbuf(f_, NULL, _IOFBF, 1 << 16);
+        return true;
+    }
+    void cerrar() { if (f_) { fclose(f_); f_ = NULL; } }
+    size_t entradas() const { return entradas_; }
+    // algun registro no llego al disco (disco lleno, error de E/S)
+    bool fallo() const { return fallo_; }
+
+    // agrupa varios registros en un solo fflush (importaciones)
+    void iniciarGrupo() { ++agrupando_; }
+    void terminarGrupo() {
+        if (--agrupando_ == 0 && f_ && !fallo_ && fflush(f_) != 0) fallo_ = true;
+    }
+
+    void empleadoCreado(const Empleado& e) {
+        if (!f_) return;
+        iniciar(DIARIO_EMPLEADO);
+        poner_cadena(buf_, e.getCarnet());
+        poner_cadena(buf_, e.getNombre());
+        poner_u32(buf_, (uint32_t)e.getFechaNacimiento().dias());
+        poner_u32(buf_, (uint32_t)e.getCategoria());
+        poner_f64(buf_, e.getSalario());
+        poner_cadena(buf_, e.getDireccion());
+        poner_cadena(buf_, e.getTelefono());
+        poner_cadena(buf_, e.getCorreo());
+        escribir();
+    }
+    void proyectoCreado(const Proyecto& p) {
+        if (!f_) return;
+        iniciar(DIARIO_PROYECTO);
+        poner_cadena(buf_, p.getCodigo());
+        poner_cadena(buf_, p.getNombre());
+        poner_u32(buf_, (uint32_t)p.getFechaInicio().dias());
+        poner_u32(buf_, (uint32_t)p.getFechaFinalizacion().dias());
+        escribir();
+    }
+    void asignacionCreada(string_view carnet, string_view codigo, Fecha fecha) {
+        if (!f_) return;
+        iniciar(DIARIO_ASIGNACION);
+        poner_cadena(buf_, carnet);
+        poner_cadena(buf_, codigo);
+        poner_u32(buf_, (uint32_t)fecha.dias());
+        escribir();
+    }
+    void correoCambiado(string_view carnet, string_view correo) {
+        if (!f_) return;
+        iniciar(DIARIO_CORREO);
+        poner_cadena(buf_, carnet);
+        poner_cadena(buf_, correo);
+        escribir();
+    }
+    void nombreProyectoCambiado(string_view codigo, string_view nombre) {
+        if (!f_) return;
+        iniciar(DIARIO_NOMBRE_PROYECTO);
+        poner_cadena(buf_, codigo);
+        poner_cadena(buf_, nombre);
+        escribir();
+    }
+    void salarioCambiado(string_view carnet, double salario) {
+        if (!f_) return;
+        iniciar(DIARIO_SALARIO);
+        poner_cadena(buf_, carnet);
+        poner_f64(buf_, salario);
+        escribir();
+    }
+    void categoriaCambiada(string_view carnet, Categoria c) {
+        if (!f_) return;
+        iniciar(DIARIO_CATEGORIA);
+        poner_cadena(buf_, carnet);
+        poner_u32(buf_, (uint32_t)c);
+        escribir();
+    }
+    void empleadoEliminado(string_view carnet) {
+        if (!f_) return;
+        iniciar(DIARIO_BAJA_EMPLEADO);
+        poner_cadena(buf_, carnet);
+        escribir();
+    }
+    void proyectoEliminado(string_view codigo) {
+        if (!f_) return;
+        iniciar(DIARIO_BAJA_PROYECTO);
+        poner_cadena(buf_, codigo);
+        escribir();
+    }
+    void asignacionQuitada(string_view carnet, string_view codigo) {
+        if (!f_) return;
+        iniciar(DIARIO_BAJA_ASIGNACION);
+        poner_cadena(buf_, carnet);
+        poner_cadena(buf_, codigo);
+        escribir();
+    }
+
+    // cierra el diario actual y lo pasa a ruta_vieja; el diario nuevo arranca vacio.
+    // Si ruta_vieja ya existe (un snapshot anterior no se llego a escribir) la union de
+    // ambos se arma en un temporal y lo reemplaza de una vez: si algo falla no se borra
+    // nada y se sigue escribiendo en el diario actual
+    bool rotar(const string& ruta_vieja) {
+        cerrar();
+        FILE* viejo = fopen(ruta_vieja.c_str(), "rb");
+        if (!viejo) {
+            if (!reemplazar_archivo(ruta_, ruta_vieja)) { reabrir(); return false; }
+        } else {
+            string tmp = ruta_vieja + ".tmp";
+            FILE* dst = fopen(tmp.c_str(), "wb");
+            bool ok = dst && anexar(viejo, dst);
+            fclose(viejo);
+            FILE* src = ok ? fopen(ruta_.c_str(), "rb") : NULL;
+            ok = src && anexar(src, dst);
+            if (src) fclose(src);
+            if (dst) {
+                ok = sincronizar_archivo(dst) && ok;
+                ok = fclose(dst) == 0 && ok;
+            }
+            if (!ok || !reemplazar_archivo(tmp, ruta_vieja)) {
+                std::remove(tmp.c_str());
+                reabrir();
+                return false;
+            }
+            std::remove(ruta_.c_str());
+        }
+        entradas_ = 0;
+        reabrir();
+        return !fallo_;
+    }
+};
+
+
+// ---- listados paginados ----
+enum TipoListado {
+    LISTADO_EMPLEADOS             = 0,
+    LISTADO_PROYECTOS             = 1,
+    LISTADO_EMPLEADOS_DE_PROYECTO = 2,
+    LISTADO_PROYECTOS_DE_EMPLEADO = 3
+};
+
+// llave de orden; las que no aplican a un listado se tratan como ORDEN_INSERCION
+enum OrdenListado {
+    ORDEN_INSERCION = 0,
+    ORDEN_LLAVE     = 1, // carnet o codigo
+    ORDEN_NOMBRE    = 2,
+    ORDEN_SALARIO   = 3, // solo empleados
+    ORDEN_FECHA     = 4  // nacimiento, inicio del proyecto o fecha de asignacion
+};
+static const int NUM_ORDENES = 5;
+
+// posicion reanudable dentro de un listado; se puede serializar como texto
+struct CursorListado {
+    TipoListado tipo;
+    OrdenListado orden;
+    string llave;       // codigo o carnet para los listados de relacion
+    size_t posicion;    // primer registro de la pagina
+    size_t tam_pagina;
+
+    CursorListado() : tipo(LISTADO_EMPLEADOS), orden(ORDEN_INSERCION), posicion(0), tam_pagina(20) {}
+
+    void siguiente() { posicion += tam_pagina; }
+    void anterior() { posicion = posicion > tam_pagina ? posicion - tam_pagina : 0; }
+
+    // "tipo:orden:posicion:tam:llave"
+    string token() const {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%d:%d:%lu:%lu:", (int)tipo, (int)orden,
+                      (unsigned long)posicion, (unsigned long)tam_pagina);
+        return string(buf) + llave;
+    }
+    bool leerToken(const string& t) {
+        int ti = 0, o = 0, usados = 0;
+        unsigned long pos = 0, tam = 0;
+        if (std::sscanf(t.c_str(), "%d:%d:%lu:%lu:%n", &ti, &o, &pos, &tam, &usados) < 4 || usados == 0)
+            return false;
+        if (ti < 0 || ti > LISTADO_PROYECTOS_DE_EMPLEADO || o < 0 || o >= NUM_ORDENES || tam == 0)
+            return false;
+        tipo = (TipoListado)ti;
+        orden = (OrdenListado)o;
+        posicion = pos;
+        tam_pagina = tam;
+        llave = t.substr((size_t)usados);
+        return true;
+    }
+};
+
+struct PaginaListado {
+    bool encontrado;    // false si la llave del listado de relacion no existe
+    size_t desde;
+    size_t hasta;       // exclusivo
+    size_t total;
+    bool hay_anterior;
+    bool hay_siguiente;
+};
+
+
+// ---- consultas de empleados por varios criterios ----
+// todos los criterios son opcionales y se combinan con "y"; los prefijos no distinguen mayusculas
+struct ConsultaEmpleados {
+    bool por_categoria;
+    Categoria categoria;
+    double salario_min;    // inclusivos
+    double salario_max;
+    Fecha nacido_desde;    // inclusivos
+    Fecha nacido_hasta;
+    string prefijo_nombre;
+    string prefijo_correo;
+    size_t limite;         // 0: todas las coincidencias
+
+    ConsultaEmpleados()
+        : por_categoria(false), categoria(CATEGORIA_ADMINISTRADOR),
+          salario_min(-numeric_limits<double>::infinity()), salario_max(numeric_limits<double>::infinity()),
+          nacido_desde(numeric_limits<int32_t>::min()), nacido_hasta(numeric_limits<int32_t>::max()), limite(0) {}
+
+    void filtrarCategoria(Categoria c) { por_categoria = true; categoria = c; }
+    // edad cumplida a 'hoy' (como calcular_edad); se traduce a un rango de nacimiento
+    void edadMinima(int anios, Fecha hoy) {
+        Fecha f = haceAnios(hoy, anios);
+        if (f < nacido_hasta) nacido_hasta = f;
+    }
+    void edadMaxima(int anios, Fecha hoy) {
+        Fecha f(haceAnios(hoy, anios + 1).dias() + 1);
+        if (f > nacido_desde) nacido_desde = f;
+    }
+    bool porSalario() const { return salario_min > -numeric_limits<double>::infinity() || salario_max < numeric_limits<double>::infinity(); }
+    bool porNacimiento() const { return nacido_desde.dias() > numeric_limits<int32_t>::min() || nacido_hasta.dias() < numeric_limits<int32_t>::max(); }
+
+private:
+    // mismo dia 'anios' atras (el 29 de febrero cae al 28 en anios no bisiestos)
+    static Fecha haceAnios(Fecha hoy, int anios) {
+        FechaCivil h = hoy.civil();
+        int y = h.anio - anios;
+        int d = h.dia > dias_del_mes(y, h.mes) ? dias_del_mes(y, h.mes) : h.dia;
+        return Fecha::desdeCivil(y, h.mes, d);
+    }
+};
+
+// camino elegido por el planificador
+enum PlanConsulta {
+    PLAN_BARRIDO = 0,  // recorrido secuencial del espejo columnar
+    PLAN_SALARIO,
+    PLAN_NACIMIENTO,
+    PLAN_NOMBRE,
+    PLAN_CORREO
+};
+static const char* const NOMBRES_PLAN[] = {
+    "barrido", "indice_salario", "indice_nacimiento", "prefijo_nombre", "prefijo_correo"
+};
+
+struct ResultadoConsulta {
+    PlanConsulta plan;
+    size_t candidatos;     // registros que el plan reviso
+    size_t coincidencias;  // antes de aplicar el limite
+    ResultadoConsulta() : plan(PLAN_BARRIDO), candidatos(0), coincidencias(0) {}
+};
+
+
+// ---- analitica de nomina ----
+static const int NUM_CATEGORIAS = 3;
+static const int BINS_HISTOGRAMA = 10; // tramos de 25000 entre 250000 y 500000
+
+struct ResumenNomina {
+    size_t cantidad;
+    double suma;
+    double minimo;
+    double maximo;
+    double edad_promedio;
+    size_t histograma[BINS_HISTOGRAMA];
+
+    ResumenNomina() : cantidad(0), suma(0.0), minimo(0.0), maximo(0.0), edad_promedio(0.0) {
+        for (int b = 0; b < BINS_HISTOGRAMA; ++b) histograma[b] = 0;
+    }
+    double promedio() const { return cantidad ? suma / (double)cantidad : 0.0; }
+};
+
+// cifras de un proyecto como vista materializada: el gestor las corrige en cada alta o
+// baja de asignacion y en cada cambio de salario o categoria de un asignado, asi que
+// leerlas no recorre asignaciones. La suma va en centimos enteros: sumar y restar
+// salarios una y otra vez no acumula error de redondeo.
+struct CifrasProyecto {
+    size_t empleados;
+    size_t por_categoria[NUM_CATEGORIAS];
+    int64_t centimos;
+
+    CifrasProyecto() : empleados(0), centimos(0) {
+        for (int c = 0; c < NUM_CATEGORIAS; ++c) por_categoria[c] = 0;
+    }
+    static int64_t aCentimos(double salario) { return (int64_t)llround(salario * 100.0); }
+    // signo +1: entra un empleado; -1: sale
+    void sumar(double salario, Categoria c, int signo) {
+        empleados += signo;
+        por_categoria[c] += signo;
+        centimos += signo * aCentimos(salario);
+    }
+    double total() const { return (double)centimos / 100.0; }
+    double promedio() const { return empleados ? total() / (double)empleados : 0.0; }
+    bool operator==(const CifrasProyecto& o) const {
+        for (int c = 0; c < NUM_CATEGORIAS; ++c) if (por_categoria[c] != o.por_categoria[c]) return false;
+        return empleados == o.empleados && centimos == o.centimos;
+    }
+};
+
+// espejo columnar (estructura de arreglos) de los campos numericos de Empleado,
+// alineado con empleados_; las reducciones recorren arreglos contiguos
+class ColumnasNomina {
+private:
+    vector<double> salario_;
+    vector<uint8_t> categoria_;
+    vector<int32_t> nacimiento_;
+    vector<uint32_t> inicio_nombre_; // primeros 4 bytes del nombre en minusculas (prefijos en el barrido)
+
+    static int tramo(double s) {
+        int b = (int)((s - 250000.0) / 25000.0);
+        return b < 0 ? 0 : (b >= BINS_HISTOGRAMA ? BINS_HISTOGRAMA - 1 : b);
+    }
+
+    // acumuladores por carril: sin dependencias entre carriles el compilador los vectoriza
+    static const int CARRILES = 4;
+    struct Acumulador {
+        double suma[CARRILES], minimo[CARRILES], maximo[CARRILES];
+        double dias[CARRILES];
+        double cantidad[CARRILES];
+        Acumulador() {
+            for (int k = 0; k < CARRILES; ++k) {
+                suma[k] = dias[k] = cantidad[k] = 0.0;
+                minimo[k] = numeric_limits<double>::infinity();
+                maximo[k] = -numeric_limits<double>::infinity();
+            }
+        }
+        void sumar(int k, bool m, double v, int32_t nac) {
+            suma[k] += m ? v : 0.0;
+            minimo[k] = (m && v < minimo[k]) ? v : minimo[k];
+            maximo[k] = (m && v > maximo[k]) ? v : maximo[k];
+            dias[k] += m ? (double)nac : 0.0;
+            cantidad[k] += m ? 1.0 : 0.0;
+        }
+        void cerrar(Fecha hoy, ResumenNomina& r) const {
+            double s = 0, d = 0, c = 0;
+            double mn = numeric_limits<double>::infinity(), mx = -numeric_limits<double>::infinity();
+            for (int k = 0; k < CARRILES; ++k) {
+                s += suma[k]; d += dias[k]; c += cantidad[k];
+                if (minimo[k] < mn) mn = minimo[k];
+                if (maximo[k] > mx) mx = maximo[k];
+            }
+            r.cantidad = (size_t)c;
+            r.suma = s;
+            r.minimo = r.cantidad ? mn : 0.0;
+            r.maximo = r.cantidad ? mx : 0.0;
+            r.edad_promedio = r.cantidad ? ((double)hoy.dias() - d / c) / 365.2425 : 0.0;
+        }
+    };
+
+public:
+    // criterios de una consulta que se resuelven sobre las columnas
+    struct Filtro {
+        int categoria;           // < 0: cualquiera
+        double salario_min, salario_max;
+        int32_t desde, hasta;    // nacimiento
+        uint32_t mascara, valor; // prefijo del nombre, hasta 4 bytes
+    };
+    static uint32_t clave_prefijo(string_view s) {
+        uint32_t k = 0;
+        for (size_t i = 0; i < 4; ++i) k = (k << 8) | (i < s.size() ? (uint8_t)tolower((unsigned char)s[i]) : 0u);
+        return k;
+    }
+    static uint32_t mascara_prefijo(size_t largo) { return largo >= 4 ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> (8 * largo)); }
+
+    void agregar(double salario, Categoria c, Fecha nacimiento, string_view nombre) {
+        salario_.push_back(salario);
+        categoria_.push_back((uint8_t)c);
+        nacimiento_.push_back(nacimiento.dias());
+        inicio_nombre_.push_back(clave_prefijo(nombre));
+    }
+    void setSalario(size_t i, double s) { salario_[i] = s; }
+    // baja de la fila i: la ultima ocupa su lugar (igual que en la tabla de registros)
+    void quitar(size_t i) {
+        size_t ultima = salario_.size() - 1;
+        salario_[i] = salario_[ultima];
+        categoria_[i] = categoria_[ultima];
+        nacimiento_[i] = nacimiento_[ultima];
+        inicio_nombre_[i] = inicio_nombre_[ultima];
+        salario_.pop_back();
+        categoria_.pop_back();
+        nacimiento_.pop_back();
+        inicio_nombre_.pop_back();
+    }
+    void setCategoria(size_t i, Categoria c) { categoria_[i] = (uint8_t)c; }
+    size_t size() const { return salario_.size(); }
+
+    bool cumple(size_t i, const Filtro& f) const {
+        return (f.categoria < 0 || categoria_[i] == f.categoria) && salario_[i] >= f.salario_min &&
+               salario_[i] <= f.salario_max && nacimiento_[i] >= f.desde && nacimiento_[i] <= f.hasta &&
+               (inicio_nombre_[i] & f.mascara) == f.valor;
+    }
+    // barrido secuencial por bloques: primero una mascara sin saltos (se vectoriza),
+    // despues se recogen las filas que cumplen
+    void filtrar(const Filtro& f, vector<size_t>& filas) const {
+        const size_t n = salario_.size(), BLOQUE = 512;
+        const double* s = salario_.empty() ? NULL : &salario_[0];
+        const uint8_t* c = categoria_.empty() ? NULL : &categoria_[0];
+        const int32_t* d = nacimiento_.empty() ? NULL : &nacimiento_[0];
+        const uint32_t* p = inicio_nombre_.empty() ? NULL : &inicio_nombre_[0];
+        // copias locales: la mascara es de bytes y podria apuntar a 'f' (el compilador no vectorizaria)
+        const uint8_t cat = (uint8_t)(f.categoria < 0 ? 0 : f.categoria), cualquiera = f.categoria < 0;
+        const double smin = f.salario_min, smax = f.salario_max;
+        const int32_t desde = f.desde, hasta = f.hasta;
+        const uint32_t mascara = f.mascara, valor = f.valor;
+        uint8_t m[BLOQUE];
+        for (size_t b = 0; b < n; b += BLOQUE) {
+            const size_t k = n - b < BLOQUE ? n - b : BLOQUE;
+            for (size_t i = 0; i < k; ++i)
+                m[i] = (uint8_t)(cualquiera | (c[b + i] == cat)) & (uint8_t)(s[b + i] >= smin) &
+                       (uint8_t)(s[b + i] <= smax) & (uint8_t)(d[b + i] >= desde) &
+                       (uint8_t)(d[b + i] <= hasta) & (uint8_t)((p[b + i] & mascara) == valor);
+            for (size_t i = 0; i < k; ++i)
+                if (m[i]) filas.push_back(b + i);
+        }
+    }
+
+    // reduccion por categoria sobre todas las filas
+    void resumirPorCategoria(Fecha hoy, ResumenNomina out[NUM_CATEGORIAS]) const {
+        const size_t n = salario_.size();
+        const double* s = salario_.empty() ? NULL : &salario_[0];
+        const uint8_t* c = categoria_.empty() ? NULL : &categoria_[0];
+        const int32_t* f = nacimiento_.empty() ? NULL : &nacimiento_[0];
+        for (int cat = 0; cat < NUM_CATEGORIAS; ++cat) {
+            Acumulador acc;
+            size_t i = 0;
+            for (; i + CARRILES <= n; i += CARRILES)
+                for (int k = 0; k < CARRILES; ++k)
+                    acc.sumar(k, c[i + k] == cat, s[i + k], f[i + k]);
+            for (; i < n; ++i) acc.sumar(0, c[i] == cat, s[i], f[i]);
+            out[cat] = ResumenNomina();
+            acc.cerrar(hoy, out[cat]);
+        }
+        for (size_t i = 0; i < n; ++i) ++out[c[i]].histograma[tramo(s[i])];
+    }
+
+    // misma reduccion sobre un subconjunto de filas (p.ej. los empleados de un proyecto)
+    void resumirFilas(const vector<size_t>& filas, Fecha hoy, ResumenNomina out[NUM_CATEGORIAS]) const {
+        Acumulador acc[NUM_CATEGORIAS];
+        for (size_t j = 0; j < filas.size(); ++j) {
+            size_t i = filas[j];
+            int cat = categoria_[i];
+            acc[cat].sumar(0, true, salario_[i], nacimiento_[i]);
+        }
+        for (int cat = 0; cat < NUM_CATEGORIAS; ++cat) {
+            out[cat] = ResumenNomina();
+            acc[cat].cerrar(hoy, out[cat]);
+        }
+        for (size_t j = 0; j < filas.size(); ++j)
+            ++out[categoria_[filas[j]]].histograma[tramo(salario_[filas[j]])];
+    }
+};
+
+
+// ---- identificadores estables ----
+// Un IdRegistro no se invalida por las bajas de otros registros: su ranura guarda
+// la posicion actual (que cambia cuando una baja rellena su hueco con el ultimo
+// registro) y la generacion descarta los ids viejos cuando la ranura se recicla.
+struct IdRegistro {
+    uint32_t ranura;
+    uint32_t generacion; // 0: id nulo
+    IdRegistro() : ranura(0), generacion(0) {}
+    IdRegistro(uint32_t r, uint32_t g) : ranura(r), generacion(g) {}
+    bool nulo() const { return generacion == 0; }
+};
+
+// mapa de ranuras con generaciones para una tabla densa de registros; ademas guarda,
+// alineados con la tabla, la ranura de cada posicion y su sello de alta (orden de creacion)
+class TablaIds {
+private:
+    static const uint32_t LIBRE = 0xFFFFFFFFu;
+    struct Ranura { uint32_t posicion; uint32_t generacion; };
+    vector<Ranura> ranuras_;
+    vector<uint32_t> libres_;
+    vector<uint32_t> ranura_de_; // posicion -> ranura
+    vector<uint64_t> sello_de_;  // posicion -> sello de alta
+    uint64_t ultimo_sello_;
+    unsigned long long bajas_;
+
+public:
+    TablaIds() : ultimo_sello_(0), bajas_(0) {}
+
+    // registro nuevo al final de la tabla
+    IdRegistro alta(uint64_t sello) {
+        uint32_t r;
+        if (!libres_.empty()) { r = libres_.back(); libres_.pop_back(); }
+        else { r = (uint32_t)ranuras_.size(); Ranura n = { LIBRE, 1 }; ranuras_.push_back(n); }
+        ranuras_[r].posicion = (uint32_t)ranura_de_.size();
+        ranura_de_.push_back(r);
+        sello_de_.push_back(sello);
+        ultimo_sello_ = sello;
+        return IdRegistro(r, ranuras_[r].generacion);
+    }
+    // baja de la posicion i: el ultimo registro pasa a ocupar su lugar (el llamador
+    // mueve sus propios datos igual); la ranura se recicla con otra generacion
+    void baja(size_t i) {
+        Ranura& x = ranuras_[ranura_de_[i]];
+        x.posicion = LIBRE;
+        if (++x.generacion == 0) x.generacion = 1;
+        libres_.push_back(ranura_de_[i]);
+        size_t ultimo = ranura_de_.size() - 1;
+        if (i != ultimo) {
+            ranura_de_[i] = ranura_de_[ultimo];
+            sello_de_[i] = sello_de_[ultimo];
+            ranuras_[ranura_de_[i]].posicion = (uint32_t)i;
+        }
+        ranura_de_.pop_back();
+        sello_de_.pop_back();
+        ++bajas_;
+    }
+    void reservar(size_t n) { ranura_de_.reserve(n); sello_de_.reserve(n); ranuras_.reserve(n); }
+
+    // posicion actual o -1 si el id ya no es vigente
+    int resolver(IdRegistro id) const {
+        if (id.ranura >= ranuras_.size()) return -1;
+        const Ranura& x = ranuras_[id.ranura];
+        return (x.generacion == id.generacion && x.posicion != LIBRE) ? (int)x.posicion : -1;
+    }
+    IdRegistro id(size_t pos) const { return IdRegistro(ranura_de_[pos], ranuras_[ranura_de_[pos]].generacion); }
+    bool viva(uint32_t ranura) const { return ranuras_[ranura].posicion != LIBRE; }
+    size_t posicion(uint32_t ranura) const { return ranuras_[ranura].posicion; }
+    uint32_t ranura(size_t pos) const { return ranura_de_[pos]; }
+    uint64_t sello(size_t pos) const { return sello_de_[pos]; }
+    const vector<uint64_t>& sellos() const { return sello_de_; }
+    uint64_t ultimoSello() const { return ultimo_sello_; }
+    unsigned long long bajas() const { return bajas_; }
+    size_t size() const { return ranura_de_.size(); }
+    bool coherente() const {
+        for (size_t p = 0; p < ranura_de_.size(); ++p)
+            if (ranura_de_[p] >= ranuras_.size() || ranuras_[ranura_de_[p]].posicion != p) return false;
+        return ranuras_.size() == ranura_de_.size() + libres_.size();
+    }
+};
+
+
+// ---- consultas por ventanas de fechas ----
+struct AsignacionFechada {
+    IdRegistro empleado;
+    IdRegistro proyecto;
+    Fecha fecha;
+};
+
+// ---- asignacion de equipos en lote ----
+enum EstadoEquipo {
+    EQUIPO_ASIGNADO = 0,
+    EQUIPO_YA_ASIGNADO,   // el par ya existia: se omite
+    EQUIPO_REPETIDO,      // carnet o proyecto repetido en el mismo lote: se omite
+    EQUIPO_NO_ENCONTRADO, // el carnet no existe: el lote no se aplica
+    NUM_ESTADOS_EQUIPO
+};
+static const char* const NOMBRES_ESTADO_EQUIPO[NUM_ESTADOS_EQUIPO] = {
+    "asignado", "ya asignado", "repetido", "no encontrado"
+};
+
+// un par del lote; carnet y proyecto son posiciones en las listas de entrada
+struct ResultadoEquipo {
+    uint32_t carnet;
+    uint32_t proyecto;
+    EstadoEquipo estado;
+};
+
+// ---- busqueda aproximada por trigramas ----
+// campos con busqueda tolerante a errores de tipeo
+enum CampoBusqueda {
+    BUSQUEDA_NOMBRE_EMPLEADO = 0,
+    BUSQUEDA_CORREO_EMPLEADO,
+    BUSQUEDA_NOMBRE_PROYECTO,
+    NUM_CAMPOS_BUSQUEDA
+};
+static const char* const NOMBRES_CAMPO_BUSQUEDA[NUM_CAMPOS_BUSQUEDA] = {
+    "nombre", "correo", "proyecto"
+};
+static bool texto_a_campo_busqueda(string_view texto, CampoBusqueda& out) {
+    string l = a_minusculas(texto);
+    for (int c = 0; c < NUM_CAMPOS_BUSQUEDA; ++c)
+        if (l == NOMBRES_CAMPO_BUSQUEDA[c]) { out = (CampoBusqueda)c; return true; }
+    return false;
+}
+
+struct CoincidenciaAproximada {
+    IdRegistro id;
+    float similitud; // |comunes| / |union| de los trigramas, en (0, 1]
+};
+
+// Indice invertido trigrama -> textos distintos (ya pasados por a_minusculas), y texto ->
+// registros por ranura de id (no cambia con las bajas de otros). Los nombres se repiten
+// mucho, asi que las listas son de textos y no de registros. Cada palabra se rellena
+// como "  palabra " (al estilo de pg_trgm): el inicio pesa mas y una letra suelta tiene trigramas.
+class IndiceTrigramas {
+public:
+    struct Candidato { float similitud; uint32_t texto; };
+
+private:
+    static constexpr uint32_t NINGUNO = 0xFFFFFFFFu;
+    struct Texto {
+        string_view clave;        // en pool_
+        uint32_t ini, num;        // tramo de sus trigramas en trigramas_
+        vector<uint32_t> ranuras; // registros con este texto
+    };
+    PoolCadenas pool_;
+    vector<Texto> textos_;
+    unordered_map<string_view, uint32_t> por_clave_;
+    vector<uint32_t> trigramas_;                        // de cada texto, ordenados y sin repetir
+    unordered_map<uint32_t, vector<uint32_t> > listas_; // trigrama -> textos
+    vector<uint32_t> texto_de_; // ranura -> texto (NINGUNO: sin registro)
+    vector<uint32_t> lugar_de_; // ranura -> posicion en textos_[t].ranuras
+    size_t huerfanos_;          // textos que se quedaron sin registros (siguen en las listas)
+
+    static bool de_palabra(char c) { return (unsigned char)c >= 0x80 || isalnum((unsigned char)c); }
+
+    float similitud(const vector<uint32_t>& q, uint32_t t) const {
+        const uint32_t* d = trigramas_.data() + textos_[t].ini;
+        size_t nd = textos_[t].num, i = 0, j = 0, comunes = 0;
+        while (i < q.size() && j < nd) {
+            if (q[i] < d[j]) ++i;
+            else if (d[j] < q[i]) ++j;
+            else { ++comunes; ++i; ++j; }
+        }
+        return (float)comunes / (float)(q.size() + nd - comunes);
+    }
+
+    // reconstruye sin los textos huerfanos (las listas nunca se recorren para borrar)
+    void compactar() {
+        IndiceTrigramas nuevo;
+        nuevo.texto_de_.assign(texto_de_.size(), NINGUNO);
+        nuevo.lugar_de_.resize(lugar_de_.size());
+        for (size_t t = 0; t < textos_.size(); ++t)
+            for (size_t k = 0; k < textos_[t].ranuras.size(); ++k) nuevo.agregar(textos_[t].ranuras[k], textos_[t].clave);
+        *this = std::move(nuevo);
+    }
+
+public:
+    IndiceTrigramas() : huerfanos_(0) {}
+
+    // trigramas de un texto ya en minusculas, ordenados y sin repetir
+    static void extraer(string_view s, vector<uint32_t>& out) {
+        out.clear();
+        size_t i = 0;
+        while (i < s.size()) {
+            while (i < s.size() && !de_palabra(s[i])) ++i;
+            size_t j = i;
+            while (j < s.size() && de_palabra(s[j])) ++j;
+            if (j > i) {
+                uint32_t a = ' ', b = ' ';
+                for (size_t k = i; k <= j; ++k) {
+                    uint32_t c = k < j ? (unsigned char)s[k] : (uint32_t)' ';
+                    out.push_back((a << 16) | (b << 8) | c);
+                    a = b;
+                    b = c;
+                }
+            }
+            i = j;
+        }
+        sort(out.begin(), out.end());
+        out.erase(unique(out.begin(), out.end()), out.end());
+    }
+
+    void agregar(uint32_t ranura, string_view texto) {
+        string low = a_minusculas(texto);
+        uint32_t t;
+        unordered_map<string_view, uint32_t>::const_iterator it = por_clave_.find(low);
+        if (it != por_clave_.end()) {
+            t = it->second;
+            if (textos_[t].ranuras.empty()) --huerfanos_;
+        } else {
+            vector<uint32_t> tri;
+            extraer(low, tri);
+            t = (uint32_t)textos_.size();
+            Texto x;
+            x.clave = pool_.internar(low);
+            x.ini = (uint32_t)trigramas_.size();
+            x.num = (uint32_t)tri.size();
+            textos_.push_back(x);
+            por_clave_[x.clave] = t;
+            trigramas_.insert(trigramas_.end(), tri.begin(), tri.end());
+            for (size_t k = 0; k < tri.size(); ++k) listas_[tri[k]].push_back(t);
+        }
+        if (ranura >= texto_de_.size()) { texto_de_.resize(ranura + 1, NINGUNO); lugar_de_.resize(ranura + 1); }
+        texto_de_[ranura] = t;
+        lugar_de_[ranura] = (uint32_t)textos_[t].ranuras.size();
+        textos_[t].ranuras.push_back(ranura);
+    }
+    void quitar(uint32_t ranura) {
+        uint32_t t = texto_de_[ranura];
+        vector<uint32_t>& rs = textos_[t].ranuras;
+        uint32_t ultima = rs.back();
+        rs[lugar_de_[ranura]] = ultima;
+        lugar_de_[ultima] = lugar_de_[ranura];
+        rs.pop_back();
+        texto_de_[ranura] = NINGUNO;
+        if (rs.empty() && ++huerfanos_ > 1024 && huerfanos_ * 2 > textos_.size()) compactar();
+    }
+
+    // Textos con similitud >= 'minima' que alcanzan para los k registros mas parecidos
+    // (los empatados con el k-esimo tambien), de mayor a menor similitud.
+    // Las listas se recorren de la mas corta a la mas larga: un texto que no salio en las
+    // primeras i comparte a lo sumo (listas - i) trigramas con la consulta, y se corta
+    // cuando esa cota ya no alcanza al k-esimo. Los candidatos se verifican con sus trigramas.
+    // Devuelve los textos revisados.
+    size_t buscar(string_view consulta, size_t k, float minima, vector<Candidato>& out) const {
+        out.clear();
+        vector<uint32_t> q;
+        extraer(a_minusculas(consulta), q);
+        if (q.empty() || k == 0) return 0;
+        vector<const vector<uint32_t>*> listas;
+        for (size_t i = 0; i < q.size(); ++i) {
+            unordered_map<uint32_t, vector<uint32_t> >::const_iterator it = listas_.find(q[i]);
+            if (it != listas_.end()) listas.push_back(&it->second);
+        }
+        sort(listas.begin(), listas.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        auto mayor = [](const Candidato& a, const Candidato& b) {
+            return a.similitud != b.similitud ? a.similitud > b.similitud : a.texto < b.texto;
+        };
+        vector<uint64_t> visto((textos_.size() + 63) / 64, 0);
+        float umbral = minima;
+        size_t revisados = 0;
+        for (size_t i = 0; i < listas.size(); ++i) {
+            if ((float)(listas.size() - i) / (float)q.size() < umbral) break;
+            size_t antes = out.size();
+            const vector<uint32_t>& l = *listas[i];
+            for (size_t p = 0; p < l.size(); ++p) {
+                uint32_t t = l[p];
+                if (visto[t >> 6] & (1ULL << (t & 63))) continue;
+                visto[t >> 6] |= 1ULL << (t & 63);
+                if (textos_[t].ranuras.empty()) continue;
+                ++revisados;
+                float s = similitud(q, t);
+                if (s >= umbral) { Candidato c = { s, t }; out.push_back(c); }
+            }
+            if (out.size() == antes) continue;
+            // sube el umbral a la similitud del texto que completa k registros
+            sort(out.begin(), out.end(), mayor);
+            size_t acumulados = 0;
+            for (size_t j = 0; j < out.size(); ++j) {
+                acumulados += textos_[out[j].texto].ranuras.size();
+                if (acumulados >= k) {
+                    umbral = out[j].similitud;
+                    while (j + 1 < out.size() && out[j + 1].similitud >= umbral) ++j;
+                    out.resize(j + 1);
+                    break;
+                }
+            }
+        }
+        return revisados;
+    }
+
+    const vector<uint32_t>& ranuras(uint32_t texto) const { return textos_[texto].ranuras; }
+    size_t textosDistintos() const { return textos_.size() - huerfanos_; }
+    size_t trigramasDistintos() const { return listas_.size(); }
+};
+
+
+// ---- estadisticas de operaciones ----
+enum Operacion {
+    OP_CREAR_EMPLEADO = 0,
+    OP_CREAR_PROYECTO,
+    OP_ASIGNAR,
+    OP_ASIGNAR_EQUIPO,
+    OP_CAMBIAR_CORREO,
+    OP_CAMBIAR_SALARIO,
+    OP_CAMBIAR_CATEGORIA,
+    OP_CAMBIAR_NOMBRE_PROYECTO,
+    OP_IMPORTAR,
+    OP_EXPORTAR,
+    OP_ELIMINAR_EMPLEADO,
+    OP_ELIMINAR_PROYECTO,
+    OP_QUITAR_ASIGNACION,
+    OP_LISTAR_EMPLEADOS,
+    OP_LISTAR_PROYECTOS,
+    OP_LISTAR_EMPLEADOS_DE_PROYECTO,
+    OP_LISTAR_PROYECTOS_DE_EMPLEADO,
+    OP_LISTAR_PAGINA,
+    OP_CONSULTAR_EMPLEADOS,
+    OP_BUSCAR_APROXIMADO,
+    OP_PROYECTOS_ACTIVOS,
+    OP_ASIGNACIONES_EN_RANGO,
+    OP_REPORTE_SOBREASIGNACION,
+    OP_REPORTE_NOMINA,
+    OP_REPORTE_COSTOS,
+    NUM_OPERACIONES
+};
+
+static const char* const NOMBRES_OPERACION[NUM_OPERACIONES] = {
+    "crear_empleado", "crear_proyecto", "asignar", "asignar_equipo", "cambiar_correo", "cambiar_salario",
+    "cambiar_categoria", "cambiar_nombre_proyecto", "importar", "exportar", "eliminar_empleado",
+    "eliminar_proyecto", "quitar_asignacion", "listar_empleados",
+    "listar_proyectos", "listar_empleados_de_proyecto", "listar_proyectos_de_empleado",
+    "listar_pagina", "consultar_empleados", "buscar_aproximado", "proyectos_activos",
+    "asignaciones_en_rango", "reporte_sobreasignacion", "reporte_nomina", "reporte_costos"
+};
+
+// contadores y latencias por operacion, y rechazos por motivo. Todo son atomicos
+// relajados sin candado: registrar cuesta unos pocos incrementos, asi que queda
+// siempre encendido. La latencia va en cubetas log2 de nanosegundos.
+class Estadisticas {
+public:
+    static const int CUBETAS = 40; // cubeta b: [2^(b-1), 2^b) ns; la ultima junta el resto
+
+private:
+    struct PorOperacion {
+        atomic<uint64_t> llamadas;
+        atomic<uint64_t> fallos;
+        atomic<uint64_t> ns_total;
+        atomic<uint64_t> ns_max;
+        atomic<uint64_t> cubetas[CUBETAS];
+    };
+    PorOperacion ops_[NUM_OPERACIONES];
+    atomic<uint64_t> rechazos_[NUM_MOTIVOS];
+
+    static int cubeta(uint64_t ns) {
+        int b = 0;
+        while (b < CUBETAS - 1 && (ns >> b) != 0) ++b;
+        return b;
+    }
+    static uint64_t leer(const atomic<uint64_t>& a) { return a.load(std::memory_order_relaxed); }
+
+    // cota superior (ns) de la cubeta donde cae el percentil q
+    uint64_t percentil(const PorOperacion& o, double q) const {
+        uint64_t total = 0;
+        for (int b = 0; b < CUBETAS; ++b) total += leer(o.cubetas[b]);
+        if (total == 0) return 0;
+        uint64_t objetivo = (uint64_t)(q * (double)total);
+        if (objetivo == 0) objetivo = 1;
+        uint64_t acumulado = 0;
+        for (int b = 0; b < CUBETAS; ++b) {
+            acumulado += leer(o.cubetas[b]);
+            if (acumulado >= objetivo) return b == 0 ? 0 : ((uint64_t)1 << b) - 1;
+        }
+        return leer(o.ns_max);
+    }
+
+public:
+    Estadisticas() { reiniciar(); }
+
+    void registrar(Operacion op, uint64_t ns, bool ok) {
+        PorOperacion& o = ops_[op];
+        o.llamadas.fetch_add(1, std::memory_order_relaxed);
+        if (!ok) o.fallos.fetch_add(1, std::memory_order_relaxed);
+        o.ns_total.fetch_add(ns, std::memory_order_relaxed);
+        o.cubetas[cubeta(ns)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t m = o.ns_max.load(std::memory_order_relaxed);
+        while (ns > m && !o.ns_max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+    }
+    void rechazo(MotivoRechazo motivo) { rechazos_[motivo].fetch_add(1, std::memory_order_relaxed); }
+
+    void reiniciar() {
+        for (int i = 0; i < NUM_OPERACIONES; ++i) {
+            ops_[i].llamadas.store(0, std::memory_order_relaxed);
+            ops_[i].fallos.store(0, std::memory_order_relaxed);
+            ops_[i].ns_total.store(0, std::memory_order_relaxed);
+            ops_[i].ns_max.store(0, std::memory_order_relaxed);
+            for (int b = 0; b < CUBETAS; ++b) ops_[i].cubetas[b].store(0, std::memory_order_relaxed);
+        }
+        for (int m = 0; m < NUM_MOTIVOS; ++m) rechazos_[m].store(0, std::memory_order_relaxed);
+    }
+
+    // tabla para el menu (solo operaciones usadas y motivos con rechazos)
+    void imprimir(ostream& os) const {
+        BufferSalida out(&os);
+        char buf[160];
+        out << "--- ESTADISTICAS DE OPERACIONES (latencias en microsegundos) ---\n";
+        std::snprintf(buf, sizeof(buf), "%-30s %10s %8s %10s %10s %10s %10s\n",
+                      "operacion", "llamadas", "fallos", "promedio", "p50<=", "p99<=", "maximo");
+        out << buf;
+        for (int i = 0; i < NUM_OPERACIONES; ++i) {
+            const PorOperacion& o = ops_[i];
+            uint64_t n = leer(o.llamadas);
+            if (n == 0) continue;
+            std::snprintf(buf, sizeof(buf), "%-30s %10llu %8llu %10.1f %10.1f %10.1f %10.1f\n",
+                          NOMBRES_OPERACION[i], (unsigned long long)n, (unsigned long long)leer(o.fallos),
+                          leer(o.ns_total) / 1e3 / (double)n, percentil(o, 0.50) / 1e3,
+                          percentil(o, 0.99) / 1e3, leer(o.ns_max) / 1e3);
+            out << buf;
+        }
+        out << "--- RECHAZOS POR MOTIVO ---\n";
+        bool alguno = false;
+        for (int m = 1; m < NUM_MOTIVOS; ++m) {
+            uint64_t n = leer(rechazos_[m]);
+            if (n == 0) continue;
+            std::snprintf(buf, sizeof(buf), "%-30s %10llu\n", NOMBRES_MOTIVO[m], (unsigned long long)n);
+            out << buf;
+            alguno = true;
+        }
+        if (!alguno) out << "(ninguno)\n";
+        out << "==========================\n";
+    }
+
+    // volcado legible por maquina: un objeto JSON por linea (operaciones, luego motivos);
+    // "cubetas" lista las cuentas por cubeta log2 de ns hasta la ultima no vacia
+    void volcarJson(ostream& os) const {
+        BufferSalida out(&os);
+        char buf[256];
+        for (int i = 0; i < NUM_OPERACIONES; ++i) {
+            const PorOperacion& o = ops_[i];
+            std::snprintf(buf, sizeof(buf),
+                          "{\"op\":\"%s\",\"llamadas\":%llu,\"fallos\":%llu,\"ns_total\":%llu,"
+                          "\"ns_max\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"cubetas\":[",
+                          NOMBRES_OPERACION[i], (unsigned long long)leer(o.llamadas),
+                          (unsigned long long)leer(o.fallos), (unsigned long long)leer(o.ns_total),
+                          (unsigned long long)leer(o.ns_max), (unsigned long long)percentil(o, 0.50),
+                          (unsigned long long)percentil(o, 0.99));
+            out << buf;
+            int ultima = CUBETAS - 1;
+            while (ultima >= 0 && leer(o.cubetas[ultima]) == 0) --ultima;
+            for (int b = 0; b <= ultima; ++b) {
+                if (b) out << ',';
+                out << (unsigned long long)leer(o.cubetas[b]);
+            }
+            out << "]}\n";
+        }
+        for (int m = 1; m < NUM_MOTIVOS; ++m) {
+            std::snprintf(buf, sizeof(buf), "{\"motivo\":\"%s\",\"rechazos\":%llu}\n",
+                          NOMBRES_MOTIVO[m], (unsigned long long)leer(rechazos_[m]));
+            out << buf;
+        }
+    }
+};
+
+// mide una llamada publica de principio a fin (incluida la espera del candado);
+// se declara antes de tomar el candado para registrar ya liberado. Cuenta como
+// fallo salvo que la operacion marque resultado(true).
+class MedicionOperacion {
+private:
+    Estadisticas& est_;
+    Operacion op_;
+    chrono::steady_clock::time_point inicio_;
+    bool ok_;
+    MedicionOperacion(const MedicionOperacion&);
+    MedicionOperacion& operator=(const MedicionOperacion&);
+public:
+    MedicionOperacion(Estadisticas& est, Operacion op)
+        : est_(est), op_(op), inicio_(chrono::steady_clock::now()), ok_(false) {}
+    ~MedicionOperacion() {
+        est_.registrar(op_, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+                                chrono::steady_clock::now() - inicio_).count(), ok_);
+    }
+    bool resultado(bool ok) { ok_ = ok; return ok; }
+};
+
+
+// Seguro para varios hilos: consultas y listados toman el candado compartido
+// (corren en paralelo), las escrituras el exclusivo, de modo que las comprobaciones
+// de unicidad/existencia y la insercion son atomicas entre si. Los metodos
+// publicos no se llaman entre ellos (shared_mutex no es recursivo).
+class GestorSistema {
+private:
+    mutable shared_mutex mutex_;
+    typedef shared_lock<shared_mutex> Lectura;
+    typedef unique_lock<shared_mutex> Escritura;
+
+    // textos de empleados, proyectos, indices y registros (internados, una copia por valor);
+    // va primero para sobrevivir a todos los miembros que guardan vistas hacia el.
+    // Compartido con las Imagen en curso: al compactarlo el pool viejo vive hasta que
+    // termina el ultimo snapshot que lo usa
+    shared_ptr<PoolCadenas> cadenas_;
+    shared_ptr<PoolCadenas> cadenas_viejas_; // mientras se compacta (ver recogerSueltas)
+    // direccion y telefono de los empleados archivados (en memoria o en disco); tambien
+    // antes que empleados_: los empleados y sus copias en una Imagen apuntan a el
+    shared_ptr<AlmacenFrio> frio_;
+    shared_ptr<AlmacenFrio> frio_viejo_;
+    // textos y registros frios que las bajas y los cambios dejaron sin dueno (estimado)
+    size_t cadenas_sueltas_;
+    size_t frios_sueltos_;
+    // cursores de la compactacion en curso: lo que queda por mover al pool o almacen nuevo
+    size_t migrar_empleados_;
+    size_t migrar_proyectos_;
+    size_t migrar_frio_;
+    // en disco, cada compactacion del almacen frio va a un archivo nuevo: ruta.N
+    string ruta_frio_;
+    size_t cache_frio_;
+    unsigned version_frio_;
+
+    // tablas densas: una baja mueve el ultimo registro al hueco (no hay compactacion
+    // aparte); los ids estables y el orden de creacion viven en ids_*
+    vector<Empleado> empleados_;
+    vector<Proyecto> proyectos_;
+    TablaIds ids_empleados_;
+    TablaIds ids_proyectos_;
+    uint64_t sellos_; // ultimo sello de alta entregado (empleados, proyectos y asignaciones)
+
+    // carnet y codigo se obtienen por posicion (no se duplican en cada asignacion);
+    // el sello de alta y la ranura de cada una viven en ids_asignaciones_
+    struct Asignacion {
+        Fecha fecha_asignacion;
+        uint32_t empleado;       // posicion en empleados_
+        uint32_t proyecto;       // posicion en proyectos_
+        uint32_t en_empleado;    // su lugar en asignaciones_por_empleado_[empleado]
+        uint32_t en_proyecto;    // y en asignaciones_por_proyecto_[proyecto]
+    };
+    vector<Asignacion> asignaciones_;
+    TablaIds ids_asignaciones_;
+
+    // adyacencia bidireccional: posiciones en asignaciones_, en orden de alta mientras no
+    // haya bajas de asignaciones (despues el orden de alta sale de los sellos)
+    vector<vector<size_t> > asignaciones_por_empleado_; // alineado con empleados_
+    vector<vector<size_t> > asignaciones_por_proyecto_; // alineado con proyectos_
+    vector<CifrasProyecto> cifras_proyecto_;            // alineado con proyectos_ (vista materializada)
+    unordered_set<unsigned long long> pares_asignados_; // (idxE << 32) | idxP
+
+    // unicidad de correos de empleados y nombres de proyectos
+    RegistroUnico correos_;
+    RegistroUnico nombres_proyecto_;
+
+    // diario en disco (NULL si no hay persistencia o durante la carga)
+    Diario* diario_;
+
+    // espejo columnar para reportes de nomina
+    ColumnasNomina columnas_;
+
+    // contadores y latencias; atomicos, se actualizan tambien bajo el candado compartido
+    mutable Estadisticas estadisticas_;
+
+    // permutaciones ordenadas para los listados y las consultas, como ranuras de ids
+    // (sobreviven a los movimientos por bajas). Se construyen con el primer uso; despues
+    // las altas se mezclan, las bajas se filtran y los cambios de campo las corrigen en su lugar
+    struct OrdenCache {
+        vector<uint32_t> ranuras;
+        bool construida;
+        uint64_t sello_visto;       // altas con sello mayor aun no incluidas
+        unsigned long long bajas_vistas;
+        OrdenCache() : construida(false), sello_visto(0), bajas_vistas(0) {}
+    };
+    // indices de consulta sin distinguir mayusculas, a continuacion de los ordenes de listado
+    enum { INDICE_NOMBRE_CI = NUM_ORDENES, INDICE_CORREO_CI, NUM_INDICES_EMPLEADO };
+    mutable OrdenCache orden_empleados_[NUM_INDICES_EMPLEADO];
+    mutable OrdenCache orden_proyectos_[NUM_ORDENES];
+    mutable mutex mutex_orden_; // los lectores comparten las permutaciones en cache
+
+    // indices de trigramas para la busqueda aproximada: se construyen con la primera
+    // busqueda (bajo mutex_orden_) y desde ahi se mantienen en cada alta, baja y cambio
+    struct TrigramasCache {
+        IndiceTrigramas indice;
+        bool construido;
+        TrigramasCache() : construido(false) {}
+    };
+    mutable TrigramasCache trigramas_[NUM_CAMPOS_BUSQUEDA];
+
+    // indices para las ventanas de fechas, tambien armados en el primer uso: las
+    // asignaciones ordenadas por fecha de asignacion y, sobre el orden de proyectos por
+    // inicio, un arbol de maximos de la fecha de fin (arbol de intervalos implicito)
+    mutable OrdenCache orden_asignaciones_;
+    struct IntervalosCache {
+        vector<int32_t> max_fin; // nodo k: hijos 2k y 2k+1; las hojas empiezan en 'hojas'
+        size_t hojas;
+        bool construido;
+        uint64_t sello_visto;    // estado del orden por inicio con que se armo
+        unsigned long long bajas_vistas;
+        IntervalosCache() : hojas(0), construido(false), sello_visto(0), bajas_vistas(0) {}
+    };
+    mutable IntervalosCache intervalos_;
+
+    // indices hash por llave primaria -> posicion en el vector
+    // (se actualizan en cada insercion; carnet y codigo no tienen setter)
+    // (las llaves son vistas al pool)
+    unordered_map<string_view, size_t> indice_empleados_;
+    unordered_map<string_view, size_t> indice_proyectos_;
+
+    // helpers de busqueda O(1) promedio
+    int buscarEmpleadoPorCarnet(string_view carnet) const {
+        unordered_map<string_view, size_t>::const_iterator it = indice_empleados_.find(carnet);
+        return it == indice_empleados_.end() ? -1 : (int)it->second;
+    }
+    int buscarProyectoPorCodigo(string_view codigo) const {
+        unordered_map<string_view, size_t>::const_iterator it = indice_proyectos_.find(codigo);
+        return it == indice_proyectos_.end() ? -1 : (int)it->second;
+    }
+    string_view textoBuscable(CampoBusqueda campo, size_t pos) const {
+        if (campo == BUSQUEDA_NOMBRE_EMPLEADO) return empleados_[pos].getNombre();
+        if (campo == BUSQUEDA_CORREO_EMPLEADO) return empleados_[pos].getCorreo();
+        return proyectos_[pos].getNombre();
+    }
+    const TablaIds& idsDe(CampoBusqueda campo) const {
+        return campo == BUSQUEDA_NOMBRE_PROYECTO ? ids_proyectos_ : ids_empleados_;
+    }
+    // bajo el candado exclusivo; sin indice construido no hay nada que mantener
+    void trigramasAlta(CampoBusqueda campo, size_t pos) {
+        if (trigramas_[campo].construido) trigramas_[campo].indice.agregar(idsDe(campo).ranura(pos), textoBuscable(campo, pos));
+    }
+    void trigramasBaja(CampoBusqueda campo, size_t pos) {
+        if (trigramas_[campo].construido) trigramas_[campo].indice.quitar(idsDe(campo).ranura(pos));
+    }
+    void indexarEmpleado() {
+        ids_empleados_.alta(++sellos_);
+        empleados_.back().internar(*cadenas_);
+        indice_empleados_[empleados_.back().getCarnet()] = empleados_.size() - 1;
+        asignaciones_por_empleado_.push_back(vector<size_t>());
+        correos_.registrar(cadenas_->internar(a_minusculas(empleados_.back().getCorreo())));
+        columnas_.agregar(empleados_.back().getSalario(), empleados_.back().getCategoria(),
+                          empleados_.back().getFechaNacimiento(), empleados_.back().getNombre());
+        trigramasAlta(BUSQUEDA_NOMBRE_EMPLEADO, empleados_.size() - 1);
+        trigramasAlta(BUSQUEDA_CORREO_EMPLEADO, empleados_.size() - 1);
+        if (diario_) diario_->empleadoCreado(empleados_.back());
+        empleados_.back().archivar(*frio_); // despues del diario: este aun lee los campos propios
+    }
+    void indexarProyecto() {
+        ids_proyectos_.alta(++sellos_);
+        proyectos_.back().internar(*cadenas_);
+        indice_proyectos_[proyectos_.back().getCodigo()] = proyectos_.size() - 1;
+        asignaciones_por_proyecto_.push_back(vector<size_t>());
+        cifras_proyecto_.push_back(CifrasProyecto());
+        nombres_proyecto_.registrar(cadenas_->internar(a_minusculas(proyectos_.back().getNombre())));
+        trigramasAlta(BUSQUEDA_NOMBRE_PROYECTO, proyectos_.size() - 1);
+        if (diario_) diario_->proyectoCreado(proyectos_.back());
+    }
+    static unsigned long long llavePar(size_t idxE, size_t idxP) {
+        return ((unsigned long long)idxE << 32) | (unsigned long long)idxP;
+    }
+    bool asignacionExiste(size_t idxE, size_t idxP) const {
+        return pares_asignados_.count(llavePar(idxE, idxP)) != 0;
+    }
+    void insertarAsignacion(size_t idxE, size_t idxP, Fecha fecha) {
+        Asignacion a;
+        a.fecha_asignacion = fecha;
+        a.empleado = (uint32_t)idxE;
+        a.proyecto = (uint32_t)idxP;
+        a.en_empleado = (uint32_t)asignaciones_por_empleado_[idxE].size();
+        a.en_proyecto = (uint32_t)asignaciones_por_proyecto_[idxP].size();
+        asignaciones_.push_back(a);
+        ids_asignaciones_.alta(++sellos_);
+        size_t pos = asignaciones_.size() - 1;
+        asignaciones_por_empleado_[idxE].push_back(pos);
+        asignaciones_por_proyecto_[idxP].push_back(pos);
+        pares_asignados_.insert(llavePar(idxE, idxP));
+        cifras_proyecto_[idxP].sumar(empleados_[idxE].getSalario(), empleados_[idxE].getCategoria(), +1);
+        if (diario_) diario_->asignacionCreada(empleados_[idxE].getCarnet(), proyectos_[idxP].getCodigo(), fecha);
+    }
+
+    // ---- bajas: sin recorrer tablas completas ----
+    // cada asignacion sabe su lugar en las dos listas: se quita en O(1) poniendo la
+    // ultima de la lista en su lugar (el orden de alta queda en los sellos)
+    void quitarDeEmpleado(const Asignacion& a) {
+        vector<size_t>& lista = asignaciones_por_empleado_[a.empleado];
+        lista[a.en_empleado] = lista.back();
+        asignaciones_[lista.back()].en_empleado = a.en_empleado;
+        lista.pop_back();
+    }
+    void quitarDeProyecto(const Asignacion& a) {
+        vector<size_t>& lista = asignaciones_por_proyecto_[a.proyecto];
+        lista[a.en_proyecto] = lista.back();
+        asignaciones_[lista.back()].en_proyecto = a.en_proyecto;
+        lista.pop_back();
+    }
+    // desengancha la asignacion 'pos' de ambos extremos; la ultima ocupa su lugar. O(1)
+    void desengancharAsignacion(size_t pos) {
+        Asignacion a = asignaciones_[pos];
+        cifras_proyecto_[a.proyecto].sumar(empleados_[a.empleado].getSalario(), empleados_[a.empleado].getCategoria(), -1);
+        quitarDeEmpleado(a);
+        quitarDeProyecto(a);
+        pares_asignados_.erase(llavePar(a.empleado, a.proyecto));
+        size_t ultima = asignaciones_.size() - 1;
+        if (pos != ultima) {
+            const Asignacion& m = asignaciones_[ultima];
+            asignaciones_por_empleado_[m.empleado][m.en_empleado] = pos;
+            asignaciones_por_proyecto_[m.proyecto][m.en_proyecto] = pos;
+            asignaciones_[pos] = m;
+        }
+        asignaciones_.pop_back();
+        ids_asignaciones_.baja(pos);
+    }
+    // baja de un empleado con sus asignaciones; libera carnet y correo en O(1)
+    void quitarEmpleado(size_t i) {
+        if (diario_) diario_->empleadoEliminado(empleados_[i].getCarnet());
+        trigramasBaja(BUSQUEDA_NOMBRE_EMPLEADO, i);
+        trigramasBaja(BUSQUEDA_CORREO_EMPLEADO, i);
+        while (!asignaciones_por_empleado_[i].empty()) desengancharAsignacion(asignaciones_por_empleado_[i].back());
+        indice_empleados_.erase(empleados_[i].getCarnet());
+        correos_.liberar(a_minusculas(empleados_[i].getCorreo()));
+        size_t ultimo = empleados_.size() - 1;
+        if (i != ultimo) {
+            empleados_[i] = std::move(empleados_[ultimo]);
+            indice_empleados_[empleados_[i].getCarnet()] = i;
+            asignaciones_por_empleado_[i].swap(asignaciones_por_empleado_[ultimo]);
+            const vector<size_t>& lista = asignaciones_por_empleado_[i];
+            for (size_t k = 0; k < lista.size(); ++k) {
+                Asignacion& a = asignaciones_[lista[k]];
+                pares_asignados_.erase(llavePar(ultimo, a.proyecto));
+                pares_asignados_.insert(llavePar(i, a.proyecto));
+                a.empleado = (uint32_t)i;
+            }
+        }
+        empleados_.pop_back();
+        asignaciones_por_empleado_.pop_back();
+        columnas_.quitar(i);
+        ids_empleados_.baja(i);
+        cadenas_sueltas_ += 4; // carnet, nombre, correo y correo en minusculas
+        ++frios_sueltos_;
+    }
+    void quitarProyecto(size_t j) {
+        if (diario_) diario_->proyectoEliminado(proyectos_[j].getCodigo());
+        trigramasBaja(BUSQUEDA_NOMBRE_PROYECTO, j);
+        while (!asignaciones_por_proyecto_[j].empty()) desengancharAsignacion(asignaciones_por_proyecto_[j].back());
+        indice_proyectos_.erase(proyectos_[j].getCodigo());
+        nombres_proyecto_.liberar(a_minusculas(proyectos_[j].getNombre()));
+        size_t ultimo = proyectos_.size() - 1;
+        if (j != ultimo) {
+            proyectos_[j] = std::move(proyectos_[ultimo]);
+            cifras_proyecto_[j] = cifras_proyecto_[ultimo];
+            indice_proyectos_[proyectos_[j].getCodigo()] = j;
+            asignaciones_por_proyecto_[j].swap(asignaciones_por_proyecto_[ultimo]);
+            const vector<size_t>& lista = asignaciones_por_proyecto_[j];
+            for (size_t k = 0; k < lista.size(); ++k) {
+                Asignacion& a = asignaciones_[lista[k]];
+                pares_asignados_.erase(llavePar(a.empleado, ultimo));
+                pares_asignados_.insert(llavePar(a.empleado, j));
+                a.proyecto = (uint32_t)j;
+            }
+        }
+        proyectos_.pop_back();
+        asignaciones_por_proyecto_.pop_back();
+        cifras_proyecto_.pop_back();
+        ids_proyectos_.baja(j);
+        cadenas_sueltas_ += 3; // codigo, nombre y nombre en minusculas
+    }
+    bool quitarAsignacionPorLlaves(const string& carnet, const string& codigo, string& error) {
+        int idxE = buscarEmpleadoPorCarnet(carnet);
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        if (idxP == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el proyecto.", error);
+        if (!asignacionExiste(idxE, idxP))
+            return rechazar(MOTIVO_NO_ENCONTRADO, "El empleado no esta asignado a ese proyecto.", error);
+        // la lista mas corta de las dos extremos tiene la asignacion
+        const vector<size_t>& le = asignaciones_por_empleado_[idxE];
+        const vector<size_t>& lp = asignaciones_por_proyecto_[idxP];
+        const vector<size_t>& lista = le.size() <= lp.size() ? le : lp;
+        for (size_t k = lista.size(); k > 0; --k) {
+            const Asignacion& a = asignaciones_[lista[k - 1]];
+            if ((int)a.empleado == idxE && (int)a.proyecto == idxP) {
+                if (diario_) diario_->asignacionQuitada(carnet, codigo);
+                desengancharAsignacion(lista[k - 1]);
+                return true;
+            }
+        }
+        return rechazar(MOTIVO_NO_ENCONTRADO, "El empleado no esta asignado a ese proyecto.", error);
+    }
+
+    // deja el mensaje en 'error' y cuenta el motivo
+    bool rechazar(MotivoRechazo motivo, const char* mensaje, string& error) const {
+        estadisticas_.rechazo(motivo);
+        error = mensaje;
+        return false;
+    }
+    bool rechazar(const Validacion& v, string& error) const { return rechazar(v.motivo, v.mensaje, error); }
+
+    // el diario no pudo escribir: el ultimo cambio quedo solo en memoria. Se informa
+    // como fallo y desde ahi se rechaza todo cambio, para no seguir alejandose del disco
+    bool diarioCaido(string& error) const {
+        if (!diario_ || !diario_->fallo()) return false;
+        rechazar(MOTIVO_DIARIO, "No se pudo escribir el diario en disco: el cambio no quedo guardado "
+                                "y no se aceptan mas cambios hasta reiniciar.", error);
+        return true;
+    }
+    bool confirmado(bool ok, string& error) const { return ok && !diarioCaido(error); }
+
+    // cambios con unicidad, sin imprimir (los usan los setters publicos y el diario)
+    bool aplicarCorreo(size_t idxE, const string& correo, string& error) {
+        Empleado& e = empleados_[idxE];
+        string anterior_low = a_minusculas(e.getCorreo());
+        string low = a_minusculas(correo);
+        Validacion v = Empleado::validarCorreo(correo);
+        if (!v.ok()) return rechazar(v, error);
+        if (low != anterior_low && correos_.existe(low))
+            return rechazar(MOTIVO_CORREO_DUPLICADO, "El correo ya esta registrado.", error);
+        trigramasBaja(BUSQUEDA_CORREO_EMPLEADO, idxE);
+        reubicarEmpleado(INDICE_CORREO_CI, idxE, [&]() {
+            e.setCorreo(correo);
+            e.internar(*cadenas_);
+        });
+        trigramasAlta(BUSQUEDA_CORREO_EMPLEADO, idxE);
+        if (low != anterior_low) {
+            correos_.liberar(anterior_low);
+            correos_.registrar(cadenas_->internar(low));
+            cadenas_sueltas_ += 2; // el correo anterior y su version en minusculas
+        }
+        if (diario_) diario_->correoCambiado(e.getCarnet(), correo);
+        return true;
+    }
+    bool aplicarNombreProyecto(size_t idxP, const string& nombre, string& error) {
+        Proyecto& p = proyectos_[idxP];
+        string anterior_low = a_minusculas(p.getNombre());
+        string low = a_minusculas(nombre);
+        Validacion v = Proyecto::validarNombre(nombre);
+        if (!v.ok()) return rechazar(v, error);
+        if (low != anterior_low && nombres_proyecto_.existe(low))
+            return rechazar(MOTIVO_NOMBRE_DUPLICADO, "El nombre del proyecto ya existe.", error);
+        trigramasBaja(BUSQUEDA_NOMBRE_PROYECTO, idxP);
+        reubicarProyecto(ORDEN_NOMBRE, idxP, [&]() {
+            p.setNombre(nombre);
+            p.internar(*cadenas_);
+        });
+        trigramasAlta(BUSQUEDA_NOMBRE_PROYECTO, idxP);
+        if (low != anterior_low) {
+            nombres_proyecto_.liberar(anterior_low);
+            nombres_proyecto_.registrar(cadenas_->internar(low));
+            cadenas_sueltas_ += 2;
+        }
+        if (diario_) diario_->nombreProyectoCambiado(p.getCodigo(), nombre);
+        return true;
+    }
+
+    bool aplicarSalario(size_t idxE, double salario, string& error) {
+        Empleado& e = empleados_[idxE];
+        Validacion v = Empleado::validarSalario(salario);
+        if (!v.ok()) return rechazar(v, error);
+        // la diferencia llega a cada proyecto del empleado: O(proyectos del empleado)
+        int64_t delta = CifrasProyecto::aCentimos(salario) - CifrasProyecto::aCentimos(e.getSalario());
+        const vector<size_t>& lista = asignaciones_por_empleado_[idxE];
+        for (size_t k = 0; k < lista.size(); ++k) cifras_proyecto_[asignaciones_[lista[k]].proyecto].centimos += delta;
+        reubicarEmpleado(ORDEN_SALARIO, idxE, [&]() { e.setSalario(salario); });
+        columnas_.setSalario(idxE, salario);
+        if (diario_) diario_->salarioCambiado(e.getCarnet(), salario);
+        return true;
+    }
+    bool aplicarCategoria(size_t idxE, const string& categoria, string& error) {
+        Empleado& e = empleados_[idxE];
+        Categoria c;
+        Validacion v = Empleado::validarCategoria(categoria, c);
+        if (!v.ok()) return rechazar(v, error);
+        const vector<size_t>& lista = asignaciones_por_empleado_[idxE];
+        for (size_t k = 0; k < lista.size(); ++k) {
+            CifrasProyecto& cp = cifras_proyecto_[asignaciones_[lista[k]].proyecto];
+            --cp.por_categoria[e.getCategoria()];
+            ++cp.por_categoria[c];
+        }
+        e.setCategoria(c);
+        columnas_.setCategoria(idxE, e.getCategoria());
+        if (diario_) diario_->categoriaCambiada(e.getCarnet(), e.getCategoria());
+        return true;
+    }
+
+    // una linea por proyecto (solo 'codigo' si se indica), en orden de alta
+    void escribirCifrasProyectos(BufferSalida& out, const string& codigo) const {
+        const vector<uint32_t>* perm = ids_proyectos_.bajas() ? &ordenProyectos(ORDEN_INSERCION) : NULL;
+        for (size_t k = 0; k < proyectos_.size(); ++k) {
+            size_t p = perm ? ids_proyectos_.posicion((*perm)[k]) : k;
+            if (!codigo.empty() && proyectos_[p].getCodigo() != codigo) continue;
+            const CifrasProyecto& c = cifras_proyecto_[p];
+            out << "- " << proyectos_[p].getCodigo() << " | " << proyectos_[p].getNombre()
+                << " | " << c.empleados << " empleados | total " << c.total()
+                << " | prom " << c.promedio()
+                << " | Adm/Op/Peon: " << c.por_categoria[0] << "/" << c.por_categoria[1] << "/" << c.por_categoria[2] << "\n";
+        }
+    }
+    void escribirFilaNomina(BufferSalida& out, const char* etiqueta, const ResumenNomina& r) const {
+        out << etiqueta << " | " << r.cantidad << " | total " << r.suma
+            << " | prom " << r.promedio() << " | min " << r.minimo << " | max " << r.maximo
+            << " | edad prom " << (int)r.edad_promedio << "\n";
+    }
+
+    // cuerpos de las modificaciones y bajas publicas (por llave o por id); idx -1: no existe
+    bool cambiarCorreoEn(int idxE, const string& correo, string& error) {
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        if (!aplicarCorreo(idxE, correo, error)) { error = "Error al cambiar correo: " + error; return false; }
+        recogerSueltas();
+        return true;
+    }
+    bool cambiarSalarioEn(int idxE, double salario, string& error) {
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        if (!aplicarSalario(idxE, salario, error)) { error = "Error al cambiar salario: " + error; return false; }
+        return true;
+    }
+    bool cambiarCategoriaEn(int idxE, const string& categoria, string& error) {
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        if (!aplicarCategoria(idxE, categoria, error)) { error = "Error al cambiar categoria: " + error; return false; }
+        return true;
+    }
+    bool cambiarNombreProyectoEn(int idxP, const string& nombre, string& error) {
+        if (idxP == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el proyecto.", error);
+        if (!aplicarNombreProyecto(idxP, nombre, error)) { error = "Error al cambiar nombre: " + error; return false; }
+        recogerSueltas();
+        return true;
+    }
+    bool eliminarEmpleadoEn(int idxE, string& error) {
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        quitarEmpleado(idxE);
+        recogerSueltas();
+        return true;
+    }
+    bool eliminarProyectoEn(int idxP, string& error) {
+        if (idxP == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el proyecto.", error);
+        quitarProyecto(idxP);
+        recogerSueltas();
+        return true;
+    }
+
+    // ---- compactacion de cadenas_ y frio_ ----
+    // las bajas y los cambios de texto no liberan nada en los pools (dedup sin conteo de
+    // referencias): cuando lo suelto pasa de la mitad se abre un pool nuevo y cada
+    // escritura mueve a el a lo sumo PASO_MIGRACION registros; al terminar el cursor se
+    // suelta el viejo. Sin pausa O(vivos); lo nuevo (altas, cambios) ya va al pool nuevo.
+    // Los cursores bajan: una baja solo trae al hueco el ultimo registro, que ya paso
+    // (o es nuevo), y migrar dos veces el mismo no cambia nada.
+    // Solo desde los cuerpos publicos: nadie debe tener vistas al pool viejo en la mano
+    static const size_t PASO_MIGRACION = 64;
+    void recogerSueltas() {
+        if (!cadenas_viejas_ && cadenas_sueltas_ > 4096 && cadenas_sueltas_ * 2 > cadenas_->cantidad()) {
+            cadenas_viejas_ = cadenas_;
+            cadenas_.reset(new PoolCadenas());
+            cadenas_->preparar(cadenas_viejas_->cantidad() - std::min(cadenas_sueltas_, cadenas_viejas_->cantidad() / 2));
+            migrar_empleados_ = empleados_.size();
+            migrar_proyectos_ = proyectos_.size();
+            cadenas_sueltas_ = 0;
+        }
+        if (cadenas_viejas_) migrarCadenas();
+        if (!frio_viejo_ && frios_sueltos_ > 4096 && frios_sueltos_ * 2 > frio_->registros()) abrirFrioNuevo();
+        if (frio_viejo_) migrarFrio();
+    }
+    void migrarCadenas() {
+        size_t paso = PASO_MIGRACION;
+        migrar_empleados_ = std::min(migrar_empleados_, empleados_.size());
+        for (; paso > 0 && migrar_empleados_ > 0; --paso) {
+            Empleado& e = empleados_[--migrar_empleados_];
+            string low = a_minusculas(e.getCorreo());
+            unordered_map<string_view, size_t>::node_type n = indice_empleados_.extract(e.getCarnet());
+            e.internar(*cadenas_);
+            if (!n.empty()) {
+                n.key() = e.getCarnet();
+                indice_empleados_.insert(std::move(n));
+            }
+            correos_.reapuntar(cadenas_->internar(low));
+        }
+        migrar_proyectos_ = std::min(migrar_proyectos_, proyectos_.size());
+        for (; paso > 0 && migrar_proyectos_ > 0; --paso) {
+            Proyecto& p = proyectos_[--migrar_proyectos_];
+            string low = a_minusculas(p.getNombre());
+            unordered_map<string_view, size_t>::node_type n = indice_proyectos_.extract(p.getCodigo());
+            p.internar(*cadenas_);
+            if (!n.empty()) {
+                n.key() = p.getCodigo();
+                indice_proyectos_.insert(std::move(n));
+            }
+            nombres_proyecto_.reapuntar(cadenas_->internar(low));
+        }
+        // todo movido: se vacia el pool viejo y recien despues se suelta. Sus bloques solo si
+        // ninguna Imagen lo comparte (las copias se toman bajo el candado; soltarlas no)
+        if (migrar_empleados_ == 0 && migrar_proyectos_ == 0 &&
+            cadenas_viejas_->soltar(PASO_MIGRACION * 64, exclusivo(cadenas_viejas_)))
+            cadenas_viejas_.reset();
+    }
+    // sin otra Imagen que lo comparta. use_count es una lectura relajada: la barrera hace
+    // visible lo que leyo el hilo que solto la ultima copia antes de liberar los bloques
+    template <class T>
+    static bool exclusivo(const shared_ptr<T>& p) {
+        if (p.use_count() != 1) return false;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+    // en disco el almacen nuevo va a otro archivo (ruta.N); si no se puede crear se sigue
+    // con el actual y se espera a otra tanda de bajas
+    void abrirFrioNuevo() {
+        frios_sueltos_ = 0;
+        shared_ptr<AlmacenFrio> nuevo(new AlmacenFrio());
+        if (frio_->enDisco()) {
+            string error;
+            if (!nuevo->abrir(ruta_frio_ + "." + to_string(++version_frio_), cache_frio_, error)) return;
+        }
+        nuevo->preparar(empleados_.size());
+        frio_viejo_ = frio_;
+        frio_ = nuevo;
+        migrar_frio_ = empleados_.size();
+    }
+    // un registro que no se puede leer se reintenta en la proxima escritura: el almacen
+    // viejo sigue vivo mientras alguien lo use, no se pierde nada
+    void migrarFrio() {
+        migrar_frio_ = std::min(migrar_frio_, empleados_.size());
+        AlmacenFrio::Contacto c;
+        for (size_t paso = PASO_MIGRACION; paso > 0 && migrar_frio_ > 0; --paso) {
+            Empleado& e = empleados_[migrar_frio_ - 1];
+            if (!e.archivadoEn(*frio_)) {
+                if (!e.contacto(c, false)) return;
+                e.reubicar(*frio_, frio_->guardar(c.direccion, c.telefono));
+            }
+            --migrar_frio_;
+        }
+        if (migrar_frio_ == 0 && frio_viejo_->soltar(PASO_MIGRACION * 64, exclusivo(frio_viejo_)))
+            frio_viejo_.reset();
+    }
+
+    // ---- motor de listados ----
+    // comparan posiciones; los empates se resuelven por orden de alta
+    struct CompararEmpleados {
+        const vector<Empleado>* v;
+        const TablaIds* ids;
+        int orden; // OrdenListado o indice de consulta
+        bool operator()(size_t a, size_t b) const {
+            const Empleado& x = (*v)[a];
+            const Empleado& y = (*v)[b];
+            int c;
+            switch (orden) {
+                case ORDEN_LLAVE:   return x.getCarnet() < y.getCarnet();
+                case ORDEN_NOMBRE:  if (x.getNombre() != y.getNombre()) return x.getNombre() < y.getNombre(); break;
+                case ORDEN_SALARIO: if (x.getSalario() != y.getSalario()) return x.getSalario() < y.getSalario(); break;
+                case ORDEN_FECHA:
+                    if (x.getFechaNacimiento() != y.getFechaNacimiento())
+                        return x.getFechaNacimiento() < y.getFechaNacimiento();
+                    break;
+                case INDICE_NOMBRE_CI:
+                    if ((c = comparar_sin_mayusculas(x.getNombre(), y.getNombre())) != 0) return c < 0;
+                    break;
+                case INDICE_CORREO_CI:
+                    if ((c = comparar_sin_mayusculas(x.getCorreo(), y.getCorreo())) != 0) return c < 0;
+                    break;
+                default: break;
+            }
+            return ids->sello(a) < ids->sello(b);
+        }
+    };
+    struct CompararProyectos {
+        const vector<Proyecto>* v;
+        const TablaIds* ids;
+        OrdenListado orden;
+        bool operator()(size_t a, size_t b) const {
+            const Proyecto& x = (*v)[a];
+            const Proyecto& y = (*v)[b];
+            switch (orden) {
+                case ORDEN_LLAVE:  return x.getCodigo() < y.getCodigo();
+                case ORDEN_NOMBRE: if (x.getNombre() != y.getNombre()) return x.getNombre() < y.getNombre(); break;
+                case ORDEN_FECHA:
+                    if (x.getFechaInicio() != y.getFechaInicio()) return x.getFechaInicio() < y.getFechaInicio();
+                    break;
+                default: break;
+            }
+            return ids->sello(a) < ids->sello(b);
+        }
+    };
+    // adapta un comparador de posiciones a las ranuras guardadas en las permutaciones
+    template <class C>
+    struct PorRanura {
+        const TablaIds* ids;
+        C cmp;
+        bool operator()(uint32_t a, uint32_t b) const { return cmp(ids->posicion(a), ids->posicion(b)); }
+    };
+    // orden de asignaciones por el registro del otro extremo (o por fecha de asignacion)
+    struct CompararAsignaciones {
+        const GestorSistema* g;
+        OrdenListado orden;
+        bool hacia_empleado;
+        bool operator()(size_t a, size_t b) const {
+            const Asignacion& x = g->asignaciones_[a];
+            const Asignacion& y = g->asignaciones_[b];
+            if (orden == ORDEN_FECHA) {
+                if (x.fecha_asignacion != y.fecha_asignacion) return x.fecha_asignacion < y.fecha_asignacion;
+                return g->ids_asignaciones_.sello(a) < g->ids_asignaciones_.sello(b);
+            }
+            if (hacia_empleado) {
+                CompararEmpleados c = { &g->empleados_, &g->ids_empleados_, orden };
+                return c(x.empleado, y.empleado);
+            }
+            CompararProyectos c = { &g->proyectos_, &g->ids_proyectos_, orden };
+            return c(x.proyecto, y.proyecto);
+        }
+    };
+
+    // pone al dia una permutacion: la construye en el primer uso; despues quita las
+    // ranuras dadas de baja (o recicladas por un alta posterior) y mezcla las altas nuevas
+    template <class C>
+    void refrescarOrden(OrdenCache& c, const TablaIds& ids, PorRanura<C> cmp) const {
+        if (!c.construida) {
+            // se ordenan posiciones (sin la indireccion por ranura) y luego se traducen
+            c.ranuras.resize(ids.size());
+            for (size_t p = 0; p < ids.size(); ++p) c.ranuras[p] = (uint32_t)p;
+            stable_sort(c.ranuras.begin(), c.ranuras.end(), cmp.cmp); // orden total: empates por alta
+            for (size_t k = 0; k < c.ranuras.size(); ++k) c.ranuras[k] = ids.ranura(c.ranuras[k]);
+        } else {
+            bool hubo_bajas = c.bajas_vistas != ids.bajas();
+            if (hubo_bajas) {
+                uint64_t visto = c.sello_visto;
+                c.ranuras.erase(remove_if(c.ranuras.begin(), c.ranuras.end(), [&](uint32_t r) {
+                    return !ids.viva(r) || ids.sello(ids.posicion(r)) > visto;
+                }), c.ranuras.end());
+            }
+            size_t previos = c.ranuras.size();
+            if (ids.ultimoSello() > c.sello_visto) {
+                // sin bajas las altas nuevas estan al final; con bajas pueden haber rellenado huecos
+                for (size_t p = hubo_bajas ? 0 : previos; p < ids.size(); ++p)
+                    if (ids.sello(p) > c.sello_visto) c.ranuras.push_back(ids.ranura(p));
+                if (c.ranuras.size() - previos <= 16) {
+                    // pocas altas: busqueda binaria (la mezcla compararia toda la permutacion)
+                    for (size_t k = previos; k < c.ranuras.size(); ++k) {
+                        uint32_t r = c.ranuras[k];
+                        vector<uint32_t>::iterator donde = upper_bound(c.ranuras.begin(), c.ranuras.begin() + k, r, cmp);
+                        std::move_backward(donde, c.ranuras.begin() + k, c.ranuras.begin() + k + 1);
+                        *donde = r;
+                    }
+                } else {
+                    sort(c.ranuras.begin() + previos, c.ranuras.end(), cmp);
+                    inplace_merge(c.ranuras.begin(), c.ranuras.begin() + previos, c.ranuras.end(), cmp);
+                }
+            }
+        }
+        c.construida = true;
+        c.sello_visto = ids.ultimoSello();
+        c.bajas_vistas = ids.bajas();
+    }
+
+    // un cambio en un campo ordenado del registro 'pos' (bajo el candado exclusivo): si la
+    // permutacion existe, se saca el registro antes del cambio y se rota solo el tramo
+    // hasta su nuevo lugar, en vez de reordenar toda la tabla en la siguiente lectura
+    template <class C, class F>
+    void reubicar(OrdenCache& c, const TablaIds& ids, PorRanura<C> cmp, size_t pos, F cambiar) {
+        if (!c.construida) { cambiar(); return; }
+        refrescarOrden(c, ids, cmp);
+        vector<uint32_t>& v = c.ranuras;
+        uint32_t r = ids.ranura(pos);
+        size_t i = lower_bound(v.begin(), v.end(), r, cmp) - v.begin();
+        cambiar();
+        if (i > 0 && cmp(r, v[i - 1])) {
+            size_t j = upper_bound(v.begin(), v.begin() + i, r, cmp) - v.begin();
+            std::rotate(v.begin() + j, v.begin() + i, v.begin() + i + 1);
+        } else if (i + 1 < v.size() && cmp(v[i + 1], r)) {
+            size_t j = lower_bound(v.begin() + i + 1, v.end(), r, cmp) - v.begin();
+            std::rotate(v.begin() + i, v.begin() + i + 1, v.begin() + j);
+        }
+    }
+    template <class F>
+    void reubicarEmpleado(int criterio, size_t pos, F cambiar) {
+        PorRanura<CompararEmpleados> c = { &ids_empleados_, { &empleados_, &ids_empleados_, criterio } };
+        reubicar(orden_empleados_[criterio], ids_empleados_, c, pos, cambiar);
+    }
+    template <class F>
+    void reubicarProyecto(OrdenListado orden, size_t pos, F cambiar) {
+        PorRanura<CompararProyectos> c = { &ids_proyectos_, { &proyectos_, &ids_proyectos_, orden } };
+        reubicar(orden_proyectos_[orden], ids_proyectos_, c, pos, cambiar);
+    }
+
+    // se llaman con el candado compartido: los campos no cambian mientras se usa la permutacion
+    const vector<uint32_t>& ordenEmpleados(int criterio) const {
+        lock_guard<mutex> lock(mutex_orden_);
+        PorRanura<CompararEmpleados> c = { &ids_empleados_, { &empleados_, &ids_empleados_, criterio } };
+        refrescarOrden(orden_empleados_[criterio], ids_empleados_, c);
+        return orden_empleados_[criterio].ranuras;
+    }
+    const vector<uint32_t>& ordenProyectos(OrdenListado orden) const {
+        lock_guard<mutex> lock(mutex_orden_);
+        PorRanura<CompararProyectos> c = { &ids_proyectos_, { &proyectos_, &ids_proyectos_, orden } };
+        refrescarOrden(orden_proyectos_[orden], ids_proyectos_, c);
+        return orden_proyectos_[orden].ranuras;
+    }
+
+    void formatearAsignacion(BufferSalida& out, size_t pos, bool hacia_empleado) const {
+        const Asignacion& a = asignaciones_[pos];
+        if (hacia_empleado) {
+            const Empleado& e = empleados_[a.empleado];
+            out << "- " << e.getCarnet()
+                << " | " << e.getNombre()
+                << " | Categoria: " << categoria_a_texto(e.getCategoria())
+                << " | Asignado el: " << a.fecha_asignacion
+                << "\n";
+        } else {
+            const Proyecto& p = proyectos_[a.proyecto];
+            out << "- " << p.getCodigo()
+                << " | " << p.getNombre()
+                << " | Asignado el: " << a.fecha_asignacion
+                << "\n";
+        }
+    }
+
+    // escribe los registros [desde, hasta) del listado; devuelve el total o -1 si la llave no existe
+    long formatearRango(TipoListado tipo, OrdenListado orden, const string& llave,
+                        size_t desde, size_t hasta, BufferSalida& out) const
+    {
+        if (tipo == LISTADO_EMPLEADOS || tipo == LISTADO_PROYECTOS) {
+            bool emp = (tipo == LISTADO_EMPLEADOS);
+            size_t total = emp ? empleados_.size() : proyectos_.size();
+            if (!emp && orden == ORDEN_SALARIO) orden = ORDEN_INSERCION;
+            // sin bajas el orden fisico ya es el de alta
+            const TablaIds& ids = emp ? ids_empleados_ : ids_proyectos_;
+            const vector<uint32_t>* perm = NULL;
+            if (orden != ORDEN_INSERCION || ids.bajas() != 0)
+                perm = emp ? &ordenEmpleados(orden) : &ordenProyectos(orden);
+            Fecha hoy = Fecha::hoy();
+            for (size_t i = desde; i < hasta && i < total; ++i) {
+                size_t idx = perm ? ids.posicion((*perm)[i]) : i;
+                out << "--------------------------\n";
+                if (emp) empleados_[idx].mostrar(out, hoy);
+                else proyectos_[idx].mostrar(out);
+            }
+            return (long)total;
+        }
+
+        bool hacia_empleado = (tipo == LISTADO_EMPLEADOS_DE_PROYECTO);
+        int idx = hacia_empleado ? buscarProyectoPorCodigo(llave) : buscarEmpleadoPorCarnet(llave);
+        if (idx == -1) return -1;
+        const vector<size_t>& lista = hacia_empleado ? asignaciones_por_proyecto_[idx]
+                                                     : asignaciones_por_empleado_[idx];
+        if (orden == ORDEN_SALARIO && !hacia_empleado) orden = ORDEN_INSERCION;
+        if (orden == ORDEN_INSERCION && ids_asignaciones_.bajas() == 0) {
+            for (size_t i = desde; i < hasta && i < lista.size(); ++i)
+                formatearAsignacion(out, lista[i], hacia_empleado);
+        } else if (orden == ORDEN_INSERCION) {
+            // las bajas reacomodan la lista: orden de alta por sello, solo hasta la pagina
+            vector<size_t> ordenada(lista);
+            size_t corte = std::min(hasta, ordenada.size());
+            const TablaIds& ids = ids_asignaciones_;
+            partial_sort(ordenada.begin(), ordenada.begin() + corte, ordenada.end(),
+                         [&ids](size_t a, size_t b) { return ids.sello(a) < ids.sello(b); });
+            for (size_t i = desde; i < corte; ++i)
+                formatearAsignacion(out, ordenada[i], hacia_empleado);
+        } else {
+            // solo se ordena la lista de adyacencia (k elementos), no toda la tabla
+            vector<size_t> ordenada(lista);
+            CompararAsignaciones c = { this, orden, hacia_empleado };
+            stable_sort(ordenada.begin(), ordenada.end(), c);
+            for (size_t i = desde; i < hasta && i < ordenada.size(); ++i)
+                formatearAsignacion(out, ordenada[i], hacia_empleado);
+        }
+        return (long)lista.size();
+    }
+
+    // ---- motor de consultas ----
+    // El planificador cuenta con dos busquedas binarias cuantos candidatos deja cada indice
+    // aplicable y recorre el menor; si ni el mejor descarta lo suficiente, barre el espejo
+    // columnar (secuencial) en vez de saltar por la tabla. El resto de criterios se revisa
+    // en cada candidato. Deja en 'filas' las posiciones en orden de alta.
+    ResultadoConsulta ejecutarConsulta(const ConsultaEmpleados& q, vector<size_t>& filas) const {
+        const size_t SALTO = 64; // un candidato por indice son varios fallos de cache; una fila del barrido, ninguno
+        const TablaIds& ids = ids_empleados_;
+        const int32_t desde = q.nacido_desde.dias(), hasta = q.nacido_hasta.dias();
+        string_view pre_nombre(q.prefijo_nombre), pre_correo(q.prefijo_correo);
+        ColumnasNomina::Filtro filtro;
+        filtro.categoria = q.por_categoria ? (int)q.categoria : -1;
+        filtro.salario_min = q.salario_min;
+        filtro.salario_max = q.salario_max;
+        filtro.desde = desde;
+        filtro.hasta = hasta;
+        filtro.mascara = ColumnasNomina::mascara_prefijo(pre_nombre.size());
+        filtro.valor = ColumnasNomina::clave_prefijo(pre_nombre) & filtro.mascara;
+        ResultadoConsulta res;
+        filas.clear();
+
+        const vector<uint32_t>* perm = NULL;
+        size_t ini = 0, fin = 0, costo = empleados_.size();
+        auto elegir = [&](PlanConsulta plan, const vector<uint32_t>& v, size_t a, size_t b) {
+            if ((b - a) * SALTO < costo) { costo = (b - a) * SALTO; perm = &v; ini = a; fin = b; res.plan = plan; }
+        };
+        auto emp = [&](uint32_t r) -> const Empleado& { return empleados_[ids.posicion(r)]; };
+        if (q.porSalario()) {
+            const vector<uint32_t>& v = ordenEmpleados(ORDEN_SALARIO);
+            size_t a = partition_point(v.begin(), v.end(), [&](uint32_t r) { return emp(r).getSalario() < q.salario_min; }) - v.begin();
+            size_t b = partition_point(v.begin() + a, v.end(), [&](uint32_t r) { return emp(r).getSalario() <= q.salario_max; }) - v.begin();
+            elegir(PLAN_SALARIO, v, a, b);
+        }
+        if (q.porNacimiento()) {
+            const vector<uint32_t>& v = ordenEmpleados(ORDEN_FECHA);
+            size_t a = partition_point(v.begin(), v.end(), [&](uint32_t r) { return emp(r).getFechaNacimiento().dias() < desde; }) - v.begin();
+            size_t b = partition_point(v.begin() + a, v.end(), [&](uint32_t r) { return emp(r).getFechaNacimiento().dias() <= hasta; }) - v.begin();
+            elegir(PLAN_NACIMIENTO, v, a, b);
+        }
+        // con el orden sin mayusculas, los que empiezan con el prefijo quedan juntos
+        // a partir del primero que no es menor que el prefijo
+        if (!pre_nombre.empty()) {
+            const vector<uint32_t>& v = ordenEmpleados(INDICE_NOMBRE_CI);
+            size_t a = partition_point(v.begin(), v.end(), [&](uint32_t r) { return comparar_sin_mayusculas(emp(r).getNombre(), pre_nombre) < 0; }) - v.begin();
+            size_t b = partition_point(v.begin() + a, v.end(), [&](uint32_t r) { return empieza_sin_mayusculas(emp(r).getNombre(), pre_nombre); }) - v.begin();
+            elegir(PLAN_NOMBRE, v, a, b);
+        }
+        if (!pre_correo.empty()) {
+            const vector<uint32_t>& v = ordenEmpleados(INDICE_CORREO_CI);
+            size_t a = partition_point(v.begin(), v.end(), [&](uint32_t r) { return comparar_sin_mayusculas(emp(r).getCorreo(), pre_correo) < 0; }) - v.begin();
+            size_t b = partition_point(v.begin() + a, v.end(), [&](uint32_t r) { return empieza_sin_mayusculas(emp(r).getCorreo(), pre_correo); }) - v.begin();
+            elegir(PLAN_CORREO, v, a, b);
+        }
+
+        // las columnas ya comparan hasta 4 bytes del nombre; el resto se revisa en el registro
+        bool revisar_nombre = pre_nombre.size() > 4 && res.plan != PLAN_NOMBRE;
+        bool revisar_correo = !pre_correo.empty() && res.plan != PLAN_CORREO;
+        auto prefijos = [&](size_t pos) {
+            const Empleado& e = empleados_[pos];
+            return (!revisar_nombre || empieza_sin_mayusculas(e.getNombre(), pre_nombre)) &&
+                   (!revisar_correo || empieza_sin_mayusculas(e.getCorreo(), pre_correo));
+        };
+        if (perm) {
+            res.candidatos = fin - ini;
+            for (size_t k = ini; k < fin; ++k) {
+                size_t pos = ids.posicion((*perm)[k]);
+                if (columnas_.cumple(pos, filtro) && prefijos(pos)) filas.push_back(pos);
+            }
+        } else {
+            res.candidatos = empleados_.size();
+            columnas_.filtrar(filtro, filas);
+            if (revisar_nombre || revisar_correo)
+                filas.erase(remove_if(filas.begin(), filas.end(), [&](size_t pos) { return !prefijos(pos); }), filas.end());
+        }
+        res.coincidencias = filas.size();
+
+        // orden de alta (el barrido sin bajas ya lo trae); el limite se aplica despues
+        if (perm || ids.bajas() != 0) {
+            auto por_alta = [&](size_t a, size_t b) { return ids.sello(a) < ids.sello(b); };
+            if (q.limite && q.limite < filas.size())
+                partial_sort(filas.begin(), filas.begin() + q.limite, filas.end(), por_alta);
+            else
+                sort(filas.begin(), filas.end(), por_alta);
+        }
+        if (q.limite && q.limite < filas.size()) filas.resize(q.limite);
+        return res;
+    }
+
+    // ---- busqueda aproximada ----
+    // se llama con el candado compartido; la primera busqueda de cada campo arma su indice
+    const IndiceTrigramas& indiceTrigramas(CampoBusqueda campo) const {
+        lock_guard<mutex> lock(mutex_orden_);
+        TrigramasCache& c = trigramas_[campo];
+        if (!c.construido) {
+            const TablaIds& ids = idsDe(campo);
+            for (size_t p = 0; p < ids.size(); ++p) c.indice.agregar(ids.ranura(p), textoBuscable(campo, p));
+            c.construido = true;
+        }
+        return c.indice;
+    }
+    // los k registros mas parecidos (similitud >= SIMILITUD_MINIMA) en 'filas', de mayor a
+    // menor similitud y, a igual similitud, en orden de alta; devuelve los textos revisados
+    size_t ejecutarBusqueda(CampoBusqueda campo, const string& texto, size_t k,
+                            vector<pair<float, size_t> >& filas) const {
+        const float SIMILITUD_MINIMA = 0.3f;
+        const IndiceTrigramas& ind = indiceTrigramas(campo);
+        const TablaIds& ids = idsDe(campo);
+        vector<IndiceTrigramas::Candidato> textos;
+        size_t revisados = ind.buscar(texto, k, SIMILITUD_MINIMA, textos);
+        filas.clear();
+        for (size_t t = 0; t < textos.size(); ++t) {
+            const vector<uint32_t>& rs = ind.ranuras(textos[t].texto);
+            for (size_t i = 0; i < rs.size(); ++i) filas.push_back(make_pair(textos[t].similitud, ids.posicion(rs[i])));
+        }
+        auto mejor = [&](const pair<float, size_t>& a, const pair<float, size_t>& b) {
+            return a.first != b.first ? a.first > b.first : ids.sello(a.second) < ids.sello(b.second);
+        };
+        if (k < filas.size()) {
+            partial_sort(filas.begin(), filas.begin() + k, filas.end(), mejor);
+            filas.resize(k);
+        } else {
+            sort(filas.begin(), filas.end(), mejor);
+        }
+        return revisados;
+    }
+
+    // ---- consultas por fechas ----
+    // se llaman con el candado compartido, como ordenEmpleados
+    const vector<uint32_t>& ordenAsignacionesPorFecha() const {
+        lock_guard<mutex> lock(mutex_orden_);
+        PorRanura<CompararAsignaciones> c = { &ids_asignaciones_, { this, ORDEN_FECHA, true } };
+        refrescarOrden(orden_asignaciones_, ids_asignaciones_, c);
+        return orden_asignaciones_.ranuras;
+    }
+    // orden de proyectos por inicio con su arbol de maximos de fin; las fechas de un
+    // proyecto no cambian, asi que el arbol solo se rehace (O(m)) tras altas o bajas
+    const vector<uint32_t>& intervalosProyectos() const {
+        lock_guard<mutex> lock(mutex_orden_);
+        OrdenCache& o = orden_proyectos_[ORDEN_FECHA];
+        PorRanura<CompararProyectos> c = { &ids_proyectos_, { &proyectos_, &ids_proyectos_, ORDEN_FECHA } };
+        refrescarOrden(o, ids_proyectos_, c);
+        IntervalosCache& t = intervalos_;
+        if (!t.construido || t.sello_visto != o.sello_visto || t.bajas_vistas != o.bajas_vistas) {
+            t.hojas = 1;
+            while (t.hojas < o.ranuras.size()) t.hojas *= 2;
+            t.max_fin.assign(2 * t.hojas, numeric_limits<int32_t>::min());
+            for (size_t k = 0; k < o.ranuras.size(); ++k)
+                t.max_fin[t.hojas + k] = proyectos_[ids_proyectos_.posicion(o.ranuras[k])].getFechaFinalizacion().dias();
+            for (size_t k = t.hojas - 1; k > 0; --k) t.max_fin[k] = std::max(t.max_fin[2 * k], t.max_fin[2 * k + 1]);
+            t.construido = true;
+            t.sello_visto = o.sello_visto;
+            t.bajas_vistas = o.bajas_vistas;
+        }
+        return o.ranuras;
+    }
+    // hojas [ini, ini + ancho) del nodo; solo baja si el tramo cae antes de 'limite'
+    // y algun fin llega a 'desde'
+    void reunirIntervalos(size_t nodo, size_t ini, size_t ancho, size_t limite, int32_t desde,
+                          const vector<uint32_t>& orden, vector<size_t>& filas) const {
+        if (ini >= limite || intervalos_.max_fin[nodo] < desde) return;
+        if (ancho == 1) { filas.push_back(ids_proyectos_.posicion(orden[ini])); return; }
+        reunirIntervalos(2 * nodo, ini, ancho / 2, limite, desde, orden, filas);
+        reunirIntervalos(2 * nodo + 1, ini + ancho / 2, ancho / 2, limite, desde, orden, filas);
+    }
+    // posiciones de los proyectos activos algun dia de [desde, hasta], en orden de inicio:
+    // los que empiezan a mas tardar en 'hasta' son un prefijo del orden, y de ese prefijo
+    // el arbol entrega los que terminan desde 'desde' en O(log m) por proyecto
+    void proyectosEnVentana(Fecha desde, Fecha hasta, vector<size_t>& filas) const {
+        filas.clear();
+        if (proyectos_.empty() || hasta < desde) return;
+        const vector<uint32_t>& v = intervalosProyectos();
+        size_t limite = partition_point(v.begin(), v.end(), [&](uint32_t r) {
+            return proyectos_[ids_proyectos_.posicion(r)].getFechaInicio() <= hasta;
+        }) - v.begin();
+        reunirIntervalos(1, 0, intervalos_.hojas, limite, desde.dias(), v, filas);
+    }
+    // posiciones de las asignaciones hechas en [desde, hasta], por fecha y luego por alta
+    void asignacionesEnVentana(Fecha desde, Fecha hasta, vector<size_t>& filas) const {
+        filas.clear();
+        if (asignaciones_.empty() || hasta < desde) return;
+        const vector<uint32_t>& v = ordenAsignacionesPorFecha();
+        auto fecha = [&](uint32_t r) { return asignaciones_[ids_asignaciones_.posicion(r)].fecha_asignacion; };
+        size_t a = partition_point(v.begin(), v.end(), [&](uint32_t r) { return fecha(r) < desde; }) - v.begin();
+        size_t b = partition_point(v.begin() + a, v.end(), [&](uint32_t r) { return fecha(r) <= hasta; }) - v.begin();
+        for (size_t k = a; k < b; ++k) filas.push_back(ids_asignaciones_.posicion(v[k]));
+    }
+
+    // insercion de registros ya validados: solo resta la unicidad
+    // alta desde los metodos publicos, sin excepciones: valida fuera del candado,
+    // construye el registro una sola vez y lo mueve al vector bajo el exclusivo
+    bool altaEmpleado(const string& carnet, const string& nombre, const string& fecha_nac,
+                      const string& categoria, double salario, const string& direccion,
+                      const string& telefono, const string& correo, string& error)
+    {
+        if (existeEmpleado(carnet))
+            return rechazar(MOTIVO_CARNET_DUPLICADO, "Aviso: ya existe un empleado con ese carnet.", error);
+        Fecha nac;
+        Categoria cat;
+        Validacion v = Empleado::validar(fecha_nac, categoria, salario, correo, Fecha::hoy(), nac, cat);
+        if (!v.ok()) {
+            rechazar(v, error);
+            error = "Error al crear empleado: " + error;
+            return false;
+        }
+        Empleado e(carnet, nombre, nac, cat, salario, direccion, telefono, correo);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return false;
+        if (buscarEmpleadoPorCarnet(carnet) != -1) // otro hilo gano la carrera
+            return rechazar(MOTIVO_CARNET_DUPLICADO, "Aviso: ya existe un empleado con ese carnet.", error);
+        if (!insertarEmpleadoValidado(e, error)) {
+            error = "Error al crear empleado: " + error;
+            return false;
+        }
+        return !diarioCaido(error);
+    }
+    bool insertarEmpleadoValidado(Empleado& e, string& error) {
+        if (buscarEmpleadoPorCarnet(e.getCarnet()) != -1)
+            return rechazar(MOTIVO_CARNET_DUPLICADO, "Ya existe un empleado con ese carnet.", error);
+        if (correos_.existe(a_minusculas(e.getCorreo())))
+            return rechazar(MOTIVO_CORREO_DUPLICADO, "El correo ya esta registrado.", error);
+        empleados_.push_back(std::move(e));
+        indexarEmpleado();
+        return true;
+    }
+    bool insertarProyectoValidado(Proyecto& p, string& error) {
+        if (buscarProyectoPorCodigo(p.getCodigo()) != -1)
+            return rechazar(MOTIVO_CODIGO_DUPLICADO, "Ya existe un proyecto con ese codigo.", error);
+        if (nombres_proyecto_.existe(a_minusculas(p.getNombre())))
+            return rechazar(MOTIVO_NOMBRE_DUPLICADO, "El nombre del proyecto ya existe.", error);
+        proyectos_.push_back(std::move(p));
+        indexarProyecto();
+        return true;
+    }
+    bool insertarAsignacionPorLlaves(const string& carnet, const string& codigo, Fecha fecha, string& error) {
+        int idxE = buscarEmpleadoPorCarnet(carnet);
+        if (idxE == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el empleado.", error);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        if (idxP == -1) return rechazar(MOTIVO_NO_ENCONTRADO, "No existe el proyecto.", error);
+        if (asignacionExiste(idxE, idxP))
+            return rechazar(MOTIVO_YA_ASIGNADO, "El empleado ya esta asignado a ese proyecto.", error);
+        insertarAsignacion(idxE, idxP, fecha);
+        return true;
+    }
+    bool insertarAsignacionImportada(const vector<string>& c, Fecha hoy, string& error) {
+        Fecha f = hoy;
+        if (!c[2].empty()) Fecha::parsear(c[2], f); // ya validada en el hilo de trabajo
+        return insertarAsignacionPorLlaves(c[0], c[1], f, error);
+    }
+
+    // valida un bloque de lineas en paralelo y confirma en orden de archivo
+    void procesarLoteImportacion(TipoImportacion tipo, bool jsonl, const vector<int>& mapa_csv,
+                                 const vector<string>& lineas, const vector<size_t>& numeros,
+                                 unsigned hilos, Fecha hoy, ReporteImportacion& rep)
+    {
+        size_t n = lineas.size();
+        size_t h = hilos;
+        if (h > n / 1024 + 1) h = n / 1024 + 1; // no vale la pena un hilo por pocas lineas
+        vector<LoteValidado> tramos(h);
+        vector<thread> trabajadores;
+        for (size_t t = 1; t < h; ++t)
+            trabajadores.push_back(thread(validar_tramo, tipo, jsonl, std::cref(mapa_csv),
+                                          std::cref(lineas), std::cref(numeros),
+                                          n * t / h, n * (t + 1) / h, hoy, std::ref(tramos[t])));
+        validar_tramo(tipo, jsonl, mapa_csv, lineas, numeros, 0, n / h, hoy, tramos[0]);
+        for (size_t t = 0; t < trabajadores.size(); ++t) trabajadores[t].join();
+
+        // la validacion corre sin candado; solo la confirmacion excluye a los demas
+        Escritura lock(mutex_);
+        for (size_t t = 0; t < h; ++t) {
+            LoteValidado& lote = tramos[t];
+            for (size_t k = 0; k < lote.lineas.size(); ++k) {
+                ErrorImportacion err;
+                err.linea = lote.lineas[k];
+                bool ok;
+                if (diarioCaido(err.mensaje))        { err.motivo = MOTIVO_DIARIO; ok = false; }
+                else if (tipo == IMPORTAR_EMPLEADOS) ok = insertarEmpleadoValidado(lote.empleados[k], err.mensaje);
+                else if (tipo == IMPORTAR_PROYECTOS) ok = insertarProyectoValidado(lote.proyectos[k], err.mensaje);
+                else                                 ok = insertarAsignacionImportada(lote.asignaciones[k], hoy, err.mensaje);
+                if (ok) ++rep.aceptadas;
+                else rep.errores.push_back(err);
+            }
+            for (size_t k = 0; k < lote.errores.size(); ++k) estadisticas_.rechazo(lote.errores[k].motivo);
+            rep.errores.insert(rep.errores.end(), lote.errores.begin(), lote.errores.end());
+        }
+    }
+
+    static bool ordenarPorLinea(const ErrorImportacion& a, const ErrorImportacion& b) {
+        return a.linea < b.linea;
+    }
+
+    // fila 'pos' de la tabla que corresponde a 'tipo', sobre las tablas de una Imagen
+    // (sin candado); false si los campos frios no se pudieron leer
+    static bool formatearFilaExportada(const vector<Empleado>& empleados, const vector<Proyecto>& proyectos,
+                                       const vector<Asignacion>& asignaciones, TipoExportacion tipo, bool jsonl,
+                                       const char* const* columnas, size_t pos, AlmacenFrio::Contacto& c,
+                                       string& out) {
+        FilaExportada fila(out, jsonl, columnas);
+        if (tipo == EXPORTAR_EMPLEADOS) {
+            const Empleado& e = empleados[pos];
+            if (!e.contacto(c, false)) return false; // recorrido completo: no desplaza la cache
+            fila.texto(e.getCarnet());
+            fila.texto(e.getNombre());
+            fila.fecha(e.getFechaNacimiento());
+            fila.texto(categoria_a_texto(e.getCategoria()));
+            fila.numero(e.getSalario());
+            fila.texto(c.direccion);
+            fila.texto(c.telefono);
+            fila.texto(e.getCorreo());
+        } else if (tipo == EXPORTAR_PROYECTOS) {
+            const Proyecto& p = proyectos[pos];
+            fila.texto(p.getCodigo());
+            fila.texto(p.getNombre());
+            fila.fecha(p.getFechaInicio());
+            fila.fecha(p.getFechaFinalizacion());
+        } else {
+            const Asignacion& a = asignaciones[pos];
+            const Empleado& e = empleados[a.empleado];
+            const Proyecto& p = proyectos[a.proyecto];
+            fila.texto(e.getCarnet());
+            fila.texto(e.getNombre());
+            fila.texto(categoria_a_texto(e.getCategoria()));
+            fila.texto(p.getCodigo());
+            fila.texto(p.getNombre());
+            fila.fecha(a.fecha_asignacion);
+        }
+        fila.terminar();
+        return true;
+    }
+
+public:
+    GestorSistema() : cadenas_(new PoolCadenas()), frio_(new AlmacenFrio()), cadenas_sueltas_(0), frios_sueltos_(0),
+                      migrar_empleados_(0), migrar_proyectos_(0), migrar_frio_(0), cache_frio_(0), version_frio_(0), sellos_(0), diario_(NULL) {}
+
+    // consultas de existencia por llave primaria
+    bool existeEmpleado(const string& carnet) const { Lectura l(mutex_); return buscarEmpleadoPorCarnet(carnet) != -1; }
+    bool existeProyecto(const string& codigo) const { Lectura l(mutex_); return buscarProyectoPorCodigo(codigo) != -1; }
+    size_t totalEmpleados() const { Lectura l(mutex_); return empleados_.size(); }
+
+    // indices y registros de unicidad coinciden con los vectores (prueba de estres)
+    bool consistente() const {
+        Lectura l(mutex_);
+        if (indice_empleados_.size() != empleados_.size() || correos_.size() != empleados_.size()) return false;
+        if (indice_proyectos_.size() != proyectos_.size() || nombres_proyecto_.size() != proyectos_.size()) return false;
+        if (asignaciones_por_empleado_.size() != empleados_.size()) return false;
+        if (asignaciones_por_proyecto_.size() != proyectos_.size()) return false;
+        if (cifras_proyecto_.size() != proyectos_.size()) return false;
+        if (ids_empleados_.size() != empleados_.size() || !ids_empleados_.coherente()) return false;
+        if (ids_proyectos_.size() != proyectos_.size() || !ids_proyectos_.coherente()) return false;
+        if (ids_asignaciones_.size() != asignaciones_.size() || !ids_asignaciones_.coherente()) return false;
+        size_t extremos = 0;
+        for (size_t i = 0; i < asignaciones_por_empleado_.size(); ++i) extremos += asignaciones_por_empleado_[i].size();
+        for (size_t j = 0; j < asignaciones_por_proyecto_.size(); ++j) extremos += asignaciones_por_proyecto_[j].size();
+        for (size_t k = 0; k < asignaciones_.size(); ++k) {
+            const Asignacion& a = asignaciones_[k];
+            if (a.empleado >= empleados_.size() || a.proyecto >= proyectos_.size()) return false;
+            // cada una esta en su lugar de las dos listas
+            if (a.en_empleado >= asignaciones_por_empleado_[a.empleado].size() ||
+                asignaciones_por_empleado_[a.empleado][a.en_empleado] != k) return false;
+            if (a.en_proyecto >= asignaciones_por_proyecto_[a.proyecto].size() ||
+                asignaciones_por_proyecto_[a.proyecto][a.en_proyecto] != k) return false;
+        }
+        // la vista materializada coincide con recalcularla desde cero
+        vector<CifrasProyecto> cifras(proyectos_.size());
+        for (size_t k = 0; k < asignaciones_.size(); ++k) {
+            const Empleado& e = empleados_[asignaciones_[k].empleado];
+            cifras[asignaciones_[k].proyecto].sumar(e.getSalario(), e.getCategoria(), +1);
+        }
+        if (cifras != cifras_proyecto_) return false;
+        return extremos == 2 * asignaciones_.size() && pares_asignados_.size() == asignaciones_.size();
+    }
+
+    // altas: el objeto se valida fuera del candado; la unicidad se comprueba e
+    // inserta bajo el exclusivo. No imprimen: el motivo del rechazo queda en 'error'.
+
+    // crear empleado sin salario (250000 por defecto)
+    bool crearEmpleado(const string& carnet, const string& nombre,
+                       const string& fecha_nac, const string& categoria,
+                       const string& direccion, const string& telefono,
+                       const string& correo, string& error)
+    {
+        MedicionOperacion med(estadisticas_, OP_CREAR_EMPLEADO);
+        return med.resultado(altaEmpleado(carnet, nombre, fecha_nac, categoria, 250000.0,
+                                          direccion, telefono, correo, error));
+    }
+
+    // crear empleado con salario
+    bool crearEmpleado(const string& carnet, const string& nombre,
+                       const string& fecha_nac, const string& categoria,
+                       double salario, const string& direccion,
+                       const string& telefono, const string& correo, string& error)
+    {
+        MedicionOperacion med(estadisticas_, OP_CREAR_EMPLEADO);
+        return med.resultado(altaEmpleado(carnet, nombre, fecha_nac, categoria, salario,
+                                          direccion, telefono, correo, error));
+    }
+
+    // crear proyecto
+    bool crearProyecto(const string& codigo, const string& nombre,
+                       const string& fecha_inicio, const string& fecha_fin, string& error)
+    {
+        MedicionOperacion med(estadisticas_, OP_CREAR_PROYECTO);
+        if (existeProyecto(codigo))
+            return rechazar(MOTIVO_CODIGO_DUPLICADO, "Aviso: ya existe un proyecto con ese codigo.", error);
+        Fecha ini, fin;
+        Validacion v = Proyecto::validar(nombre, fecha_inicio, fecha_fin, ini, fin);
+        if (!v.ok()) {
+            rechazar(v, error);
+            error = "Error al crear proyecto: " + error;
+            return false;
+        }
+        Proyecto p(codigo, nombre, ini, fin);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        if (buscarProyectoPorCodigo(codigo) != -1) // otro hilo gano la carrera
+            return rechazar(MOTIVO_CODIGO_DUPLICADO, "Aviso: ya existe un proyecto con ese codigo.", error);
+        if (!insertarProyectoValidado(p, error)) {
+            error = "Error al crear proyecto: " + error;
+            return false;
+        }
+        return med.resultado(!diarioCaido(error));
+    }
+
+    // cambiar correo de un empleado (libera el anterior en el registro)
+    bool cambiarCorreoEmpleado(const string& carnet, const string& correo, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_CORREO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarCorreoEn(buscarEmpleadoPorCarnet(carnet), correo, error), error));
+    }
+    bool cambiarCorreoEmpleado(IdRegistro id, const string& correo, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_CORREO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarCorreoEn(ids_empleados_.resolver(id), correo, error), error));
+    }
+
+    // cambiar salario / categoria (mantienen al dia el espejo columnar)
+    bool cambiarSalarioEmpleado(const string& carnet, double salario, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_SALARIO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarSalarioEn(buscarEmpleadoPorCarnet(carnet), salario, error), error));
+    }
+    bool cambiarSalarioEmpleado(IdRegistro id, double salario, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_SALARIO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarSalarioEn(ids_empleados_.resolver(id), salario, error), error));
+    }
+    bool cambiarCategoriaEmpleado(const string& carnet, const string& categoria, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_CATEGORIA);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarCategoriaEn(buscarEmpleadoPorCarnet(carnet), categoria, error), error));
+    }
+    bool cambiarCategoriaEmpleado(IdRegistro id, const string& categoria, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_CATEGORIA);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarCategoriaEn(ids_empleados_.resolver(id), categoria, error), error));
+    }
+
+    // cambiar nombre de un proyecto (libera el anterior en el registro)
+    bool cambiarNombreProyecto(const string& codigo, const string& nombre, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_NOMBRE_PROYECTO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarNombreProyectoEn(buscarProyectoPorCodigo(codigo), nombre, error), error));
+    }
+    bool cambiarNombreProyecto(IdRegistro id, const string& nombre, string& error) {
+        MedicionOperacion med(estadisticas_, OP_CAMBIAR_NOMBRE_PROYECTO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(cambiarNombreProyectoEn(ids_proyectos_.resolver(id), nombre, error), error));
+    }
+
+    // ---- bajas ----
+    // ids estables: siguen resolviendo al mismo registro aunque otros se den de baja;
+    // el de un registro eliminado no vuelve a resolver (ni si su ranura se recicla)
+    IdRegistro idEmpleado(const string& carnet) const {
+        Lectura l(mutex_);
+        int idxE = buscarEmpleadoPorCarnet(carnet);
+        return idxE == -1 ? IdRegistro() : ids_empleados_.id(idxE);
+    }
+    IdRegistro idProyecto(const string& codigo) const {
+        Lectura l(mutex_);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        return idxP == -1 ? IdRegistro() : ids_proyectos_.id(idxP);
+    }
+    bool mostrarEmpleado(IdRegistro id, ostream& os) const {
+        Lectura l(mutex_);
+        int idxE = ids_empleados_.resolver(id);
+        if (idxE != -1) empleados_[idxE].mostrar(os);
+        return idxE != -1;
+    }
+    bool mostrarProyecto(IdRegistro id, ostream& os) const {
+        Lectura l(mutex_);
+        int idxP = ids_proyectos_.resolver(id);
+        if (idxP != -1) proyectos_[idxP].mostrar(os);
+        return idxP != -1;
+    }
+
+    // eliminar un empleado o proyecto junto con sus asignaciones: el trabajo es
+    // proporcional a sus asignaciones, no al tamano de las tablas
+    bool eliminarEmpleado(const string& carnet, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ELIMINAR_EMPLEADO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(eliminarEmpleadoEn(buscarEmpleadoPorCarnet(carnet), error), error));
+    }
+    bool eliminarEmpleado(IdRegistro id, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ELIMINAR_EMPLEADO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(eliminarEmpleadoEn(ids_empleados_.resolver(id), error), error));
+    }
+    bool eliminarProyecto(const string& codigo, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ELIMINAR_PROYECTO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(eliminarProyectoEn(buscarProyectoPorCodigo(codigo), error), error));
+    }
+    bool eliminarProyecto(IdRegistro id, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ELIMINAR_PROYECTO);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(eliminarProyectoEn(ids_proyectos_.resolver(id), error), error));
+    }
+    bool quitarAsignacion(const string& carnet, const string& codigo, string& error) {
+        MedicionOperacion med(estadisticas_, OP_QUITAR_ASIGNACION);
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(quitarAsignacionPorLlaves(carnet, codigo, error), error));
+    }
+
+    // importacion masiva desde un flujo CSV (con cabecera) o JSONL.
+    // Se lee por bloques, se valida en paralelo y se confirma en orden;
+    // las filas rechazadas quedan en rep.errores en vez de imprimirse.
+    bool importar(TipoImportacion tipo, istream& in, bool jsonl,
+                  ReporteImportacion& rep, unsigned hilos = 0)
+    {
+        MedicionOperacion med(estadisticas_, OP_IMPORTAR);
+        const size_t TAM_LOTE = 65536;
+        if (hilos == 0) hilos = thread::hardware_concurrency();
+        if (hilos == 0) hilos = 1;
+
+        const char* const* nombres;
+        size_t ncol = columnas_de(tipo, nombres);
+        vector<int> mapa_csv;
+        bool cabecera = jsonl; // JSONL no lleva cabecera
+        Fecha hoy = Fecha::hoy(); // una sola vez para todo el lote
+        grupoDiario(true);
+
+        vector<string> lineas;
+        vector<size_t> numeros;
+        lineas.reserve(TAM_LOTE);
+        numeros.reserve(TAM_LOTE);
+        string linea;
+        size_t nlinea = 0;
+        while (getline(in, linea)) {
+            ++nlinea;
+            if (!linea.empty() && linea[linea.size() - 1] == '\r') linea.erase(linea.size() - 1);
+            if (linea.find_first_not_of(" \t") == string::npos) continue;
+
+            if (!cabecera) {
+                vector<string> cols;
+                separar_csv(linea, cols);
+                vector<bool> vistas(ncol, false);
+                for (size_t k = 0; k < cols.size(); ++k) {
+                    int col = columna_canonica(tipo, cols[k]);
+                    mapa_csv.push_back(col);
+                    if (col >= 0) vistas[col] = true;
+                }
+                for (size_t k = 0; k < ncol; ++k) {
+                    bool opcional = (tipo == IMPORTAR_EMPLEADOS && (k == 4 || k == 5 || k == 6)) ||
+                                    (tipo == IMPORTAR_ASIGNACIONES && k == 2);
+                    if (!vistas[k] && !opcional) {
+                        ErrorImportacion err;
+                        err.linea = nlinea;
+                        err.mensaje = string("Falta la columna obligatoria: ") + nombres[k];
+                        estadisticas_.rechazo(err.motivo);
+                        rep.errores.push_back(err);
+                        grupoDiario(false);
+                        return false;
+                    }
+                }
+                cabecera = true;
+                continue;
+            }
+
+            lineas.push_back(linea);
+            numeros.push_back(nlinea);
+            ++rep.leidas;
+            if (lineas.size() == TAM_LOTE) {
+                procesarLoteImportacion(tipo, jsonl, mapa_csv, lineas, numeros, hilos, hoy, rep);
+                lineas.clear();
+                numeros.clear();
+            }
+        }
+        if (!lineas.empty())
+            procesarLoteImportacion(tipo, jsonl, mapa_csv, lineas, numeros, hilos, hoy, rep);
+        grupoDiario(false);
+        stable_sort(rep.errores.begin(), rep.errores.end(), ordenarPorLinea);
+        // las filas aceptadas del ultimo tramo sin fflush pueden no haber llegado al disco
+        ErrorImportacion caido;
+        if (!diarioSano(caido.mensaje)) {
+            caido.motivo = MOTIVO_DIARIO;
+            rep.errores.insert(rep.errores.begin(), caido);
+            return med.resultado(false);
+        }
+        return med.resultado(true);
+    }
+
+    // igual que importar(), detectando JSONL por la extension (.jsonl/.ndjson/.json)
+    bool importarArchivo(TipoImportacion tipo, const string& ruta,
+                         ReporteImportacion& rep, unsigned hilos = 0)
+    {
+        vector<char> buffer(1 << 20);
+        ifstream in;
+        in.rdbuf()->pubsetbuf(&buffer[0], (streamsize)buffer.size());
+        in.open(ruta.c_str(), ios::in | ios::binary);
+        if (!in) return false;
+        string ext = a_minusculas(ruta.substr(ruta.find_last_of('.') == string::npos ? ruta.size()
+                                                                              : ruta.find_last_of('.')));
+        bool jsonl = (ext == ".jsonl" || ext == ".ndjson" || ext == ".json");
+        return importar(tipo, in, jsonl, rep, hilos);
+    }
+
+    // exportacion masiva a CSV (con cabecera) o JSONL, en orden de alta. El candado
+    // compartido solo dura la copia de una Imagen (consistente; comparte el pool y el
+    // almacen frio): el formato y las escrituras van fuera y no detienen las altas.
+    // Los hilos viven toda la exportacion y llenan tramos en un anillo de 2 por hilo;
+    // este hilo los escribe en orden con una escritura grande cada uno mientras los
+    // demas ya formatean los siguientes. Ademas de la imagen, la memoria queda acotada
+    // a 2 * hilos * tramo sin importar el tamano de la tabla.
+    bool exportar(TipoExportacion tipo, ostream& os, bool jsonl,
+                  ReporteExportacion& rep, unsigned hilos = 0) const
+    {
+        MedicionOperacion med(estadisticas_, OP_EXPORTAR);
+        const size_t TAM_TRAMO = 8192;
+        if (hilos == 0) hilos = thread::hardware_concurrency();
+        if (hilos == 0) hilos = 1;
+        Imagen img;
+        capturarImagen(img);
+
+        const char* const* columnas;
+        size_t ncol = columnas_exportadas(tipo, columnas);
+        if (!jsonl) {
+            string cab;
+            for (size_t k = 0; k < ncol; ++k) { if (k) cab += ','; cab += columnas[k]; }
+            cab += '\n';
+            os.write(cab.data(), (streamsize)cab.size());
+            rep.bytes += cab.size();
+        }
+
+        // posiciones en orden de alta: sin bajas los sellos ya vienen ordenados
+        const vector<uint64_t>& sellos = tipo == EXPORTAR_EMPLEADOS ? img.sellos_empleados
+                                       : tipo == EXPORTAR_PROYECTOS ? img.sellos_proyectos : img.sellos_asignaciones;
+        size_t n = sellos.size();
+        vector<uint32_t> orden, destino;
+        if (!std::is_sorted(sellos.begin(), sellos.end())) ordenDeAlta(sellos, orden, destino);
+
+        size_t ntramos = (n + TAM_TRAMO - 1) / TAM_TRAMO;
+        size_t h = std::min<size_t>(hilos, ntramos);
+        // ranura r guarda el tramo turnos[r]; listos[r] cuando ya se puede escribir
+        vector<string> textos(2 * h);
+        vector<size_t> turnos(2 * h);
+        vector<char> listos(2 * h, 0);
+        for (size_t r = 0; r < turnos.size(); ++r) turnos[r] = r;
+        mutex m;
+        condition_variable cv;
+        bool cancelar = false; // un campo frio ilegible o una escritura fallida: no se exportan blancos
+        auto trabajar = [&](size_t t) {
+            AlmacenFrio::Contacto c;
+            for (size_t tramo = t; tramo < ntramos; tramo += h) {
+                size_t r = tramo % textos.size();
+                {
+                    unique_lock<mutex> l(m);
+                    cv.wait(l, [&] { return cancelar || turnos[r] == tramo; });
+                    if (cancelar) return;
+                }
+                string& out = textos[r];
+                out.clear();
+                bool ok = true;
+                for (size_t k = tramo * TAM_TRAMO; k < std::min(n, (tramo + 1) * TAM_TRAMO) && ok; ++k)
+                    ok = formatearFilaExportada(img.empleados, img.proyectos, img.asignaciones, tipo, jsonl,
+                                                columnas, orden.empty() ? k : orden[k], c, out);
+                {
+                    lock_guard<mutex> l(m);
+                    if (ok) listos[r] = 1;
+                    else cancelar = true;
+                }
+                cv.notify_all();
+            }
+        };
+        vector<thread> trabajadores;
+        for (size_t t = 0; t < h; ++t) trabajadores.push_back(thread(trabajar, t));
+        bool ok = true;
+        for (size_t tramo = 0; tramo < ntramos && ok; ++tramo) {
+            size_t r = tramo % textos.size();
+            {
+                unique_lock<mutex> l(m);
+                cv.wait(l, [&] { return cancelar || listos[r]; });
+                if (cancelar) { ok = false; break; }
+            }
+            os.write(textos[r].data(), (streamsize)textos[r].size());
+            rep.bytes += textos[r].size();
+            if (!os) ok = false;
+            {
+                lock_guard<mutex> l(m);
+                listos[r] = 0;
+                turnos[r] = tramo + textos.size();
+                if (!ok) cancelar = true;
+            }
+            cv.notify_all();
+        }
+        for (size_t t = 0; t < trabajadores.size(); ++t) trabajadores[t].join();
+        if (!ok) return med.resultado(false);
+        rep.filas = n;
+        os.flush();
+        return med.resultado((bool)os);
+    }
+
+    // igual que exportar(), con JSONL si la extension es .jsonl/.ndjson/.json
+    bool exportarArchivo(TipoExportacion tipo, const string& ruta,
+                         ReporteExportacion& rep, unsigned hilos = 0) const
+    {
+        vector<char> buffer(1 << 20);
+        ofstream out;
+        out.rdbuf()->pubsetbuf(&buffer[0], (streamsize)buffer.size());
+        out.open(ruta.c_str(), ios::out | ios::binary | ios::trunc);
+        if (!out) return false;
+        string ext = a_minusculas(ruta.substr(ruta.find_last_of('.') == string::npos ? ruta.size()
+                                                                              : ruta.find_last_of('.')));
+        bool jsonl = (ext == ".jsonl" || ext == ".ndjson" || ext == ".json");
+        return exportar(tipo, out, jsonl, rep, hilos);
+    }
+
+    // ---- persistencia ----
+    // copia consistente del estado para escribir el snapshot fuera del hilo principal
+    // (los textos son vistas al pool del gestor y los frios viven en su almacen: la
+    // imagen comparte ambos, asi una compactacion no los libera mientras viva)
+    // (las bajas desordenan las tablas: los sellos permiten guardar en orden de alta)
+    struct Imagen {
+        shared_ptr<const PoolCadenas> cadenas, cadenas_viejas;
+        shared_ptr<const AlmacenFrio> frio, frio_viejo;
+        vector<Empleado> empleados;
+        vector<Proyecto> proyectos;
+        vector<Asignacion> asignaciones;
+        vector<uint64_t> sellos_empleados;
+        vector<uint64_t> sellos_proyectos;
+        vector<uint64_t> sellos_asignaciones;
+    };
+    void copiarImagen(Imagen& img) const {
+        img.cadenas = cadenas_;
+        img.cadenas_viejas = cadenas_viejas_;
+        img.frio = frio_;
+        img.frio_viejo = frio_viejo_;
+        img.empleados = empleados_;
+        img.proyectos = proyectos_;
+        img.asignaciones = asignaciones_;
+        img.sellos_empleados = ids_empleados_.sellos();
+        img.sellos_proyectos = ids_proyectos_.sellos();
+        img.sellos_asignaciones = ids_asignaciones_.sellos();
+    }
+    void capturarImagen(Imagen& img) const {
+        Lectura l(mutex_);
+        copiarImagen(img);
+    }
+    // imagen + rotacion del diario como un solo corte: ninguna escritura queda
+    // fuera de ambos (ni en el snapshot ni en el diario nuevo)
+    bool capturarImagenYRotar(Imagen& img, const string& ruta_vieja) {
+        Escritura l(mutex_);
+        copiarImagen(img);
+        return diario_ && diario_->rotar(ruta_vieja);
+    }
+    void conectarDiario(Diario* d) { Escritura l(mutex_); diario_ = d; }
+    bool diarioSano(string& error) const { Lectura l(mutex_); return !diarioCaido(error); }
+    // agrupa los registros del diario en un solo fflush (importaciones, lotes de comandos)
+    void grupoDiario(bool iniciar) {
+        Escritura lock(mutex_);
+        if (!diario_) return;
+        if (iniciar) diario_->iniciarGrupo();
+        else diario_->terminarGrupo();
+    }
+
+    // posiciones ordenadas por sello y su inversa (posicion actual -> posicion en disco)
+    static void ordenDeAlta(const vector<uint64_t>& sellos, vector<uint32_t>& orden, vector<uint32_t>& destino) {
+        orden.resize(sellos.size());
+        for (size_t i = 0; i < orden.size(); ++i) orden[i] = (uint32_t)i;
+        sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) { return sellos[a] < sellos[b]; });
+        destino.resize(orden.size());
+        for (size_t i = 0; i < orden.size(); ++i) destino[orden[i]] = (uint32_t)i;
+    }
+
+    static bool escribirSnapshot(const Imagen& img, const string& ruta, string& error) {
+        // tabla de cadenas deduplicada (direcciones y codigos se repiten mucho)
+        vector<char> tabla;
+        unordered_map<string_view, uint32_t> offs;
+        struct Interno {
+            static uint32_t cadena(vector<char>& t, unordered_map<string_view, uint32_t>& o, string_view s) {
+                unordered_map<string_view, uint32_t>::iterator it = o.find(s);
+                if (it != o.end()) return it->second;
+                uint32_t off = (uint32_t)t.size();
+                poner_cadena(t, s);
+                o[s] = off;
+                return off;
+            }
+        };
+        vector<uint32_t> orden_emp, destino_emp, orden_proy, destino_proy;
+        ordenDeAlta(img.sellos_empleados, orden_emp, destino_emp);
+        ordenDeAlta(img.sellos_proyectos, orden_proy, destino_proy);
+        // los campos frios llegan por copia: se internan aqui para que las llaves de 'offs' vivan
+        PoolCadenas frias;
+        AlmacenFrio::Contacto c;
+        vector<EmpleadoDisco> emps(img.empleados.size());
+        for (size_t i = 0; i < img.empleados.size(); ++i) {
+            const Empleado& e = img.empleados[orden_emp[i]];
+            EmpleadoDisco& r = emps[i];
+            r.carnet = Interno::cadena(tabla, offs, e.getCarnet());
+            r.nombre = Interno::cadena(tabla, offs, e.getNombre());
+            r.fecha_nacimiento = e.getFechaNacimiento().dias();
+            if (!e.contacto(c, false)) { error = "No se pudo leer el almacen frio."; return false; }
+            r.direccion = Interno::cadena(tabla, offs, frias.internar(c.direccion));
+            r.telefono = Interno::cadena(tabla, offs, frias.internar(c.telefono));
+            r.correo = Interno::cadena(tabla, offs, e.getCorreo());
+            r.categoria = (uint32_t)e.getCategoria();
+            r.reservado = 0;
+            r.salario = e.getSalario();
+        }
+        vector<ProyectoDisco> proys(img.proyectos.size());
+        for (size_t i = 0; i < img.proyectos.size(); ++i) {
+            const Proyecto& p = img.proyectos[orden_proy[i]];
+            proys[i].codigo = Interno::cadena(tabla, offs, p.getCodigo());
+            proys[i].nombre = Interno::cadena(tabla, offs, p.getNombre());
+            proys[i].fecha_inicio = p.getFechaInicio().dias();
+            proys[i].fecha_finalizacion = p.getFechaFinalizacion().dias();
+        }
+        vector<uint32_t> orden_asig, destino_asig;
+        ordenDeAlta(img.sellos_asignaciones, orden_asig, destino_asig);
+        vector<AsignacionDisco> asigs(img.asignaciones.size());
+        for (size_t i = 0; i < img.asignaciones.size(); ++i) {
+            const Asignacion& a = img.asignaciones[orden_asig[i]];
+            asigs[i].empleado = destino_emp[a.empleado];
+            asigs[i].proyecto = destino_proy[a.proyecto];
+            asigs[i].fecha = a.fecha_asignacion.dias();
+            asigs[i].reservado = 0;
+        }
+        if (tabla.size() > 0xFFFFFFFFu) { error = "Tabla de cadenas demasiado grande."; return false; }
+        while (tabla.size() % 8) tabla.push_back(0); // registros alineados a 8
+
+        CabeceraSnapshot cab;
+        std::memcpy(cab.magia, "GSNP", 4);
+        cab.version = VERSION_SNAPSHOT;
+        cab.n_empleados = emps.size();
+        cab.n_proyectos = proys.size();
+        cab.n_asignaciones = asigs.size();
+        cab.off_cadenas = sizeof(CabeceraSnapshot);
+        cab.tam_cadenas = tabla.size();
+        cab.off_empleados = cab.off_cadenas + cab.tam_cadenas;
+        cab.off_proyectos = cab.off_empleados + emps.size() * sizeof(EmpleadoDisco);
+        cab.off_asignaciones = cab.off_proyectos + proys.size() * sizeof(ProyectoDisco);
+
+        string tmp = ruta + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if (!f) { error = "No se pudo crear " + tmp; return false; }
+        setvbuf(f, NULL, _IOFBF, 1 << 20);
+        bool ok = fwrite(&cab, sizeof(cab), 1, f) == 1;
+        if (ok && !tabla.empty()) ok = fwrite(&tabla[0], 1, tabla.size(), f) == tabla.size();
+        if (ok && !emps.empty())  ok = fwrite(&emps[0], sizeof(EmpleadoDisco), emps.size(), f) == emps.size();
+        if (ok && !proys.empty()) ok = fwrite(&proys[0], sizeof(ProyectoDisco), proys.size(), f) == proys.size();
+        if (ok && !asigs.empty()) ok = fwrite(&asigs[0], sizeof(AsignacionDisco), asigs.size(), f) == asigs.size();
+        ok = sincronizar_archivo(f) && ok;
+        fclose(f);
+        if (!ok || !reemplazar_archivo(tmp, ruta)) {
+            std::remove(tmp.c_str());
+            error = "No se pudo escribir " + ruta;
+            return false;
+        }
+        return true;
+    }
+
+    // carga un snapshot sobre un gestor vacio; cada registro pasa por las mismas
+    // validaciones y controles de unicidad que un alta (el archivo pudo corromperse)
+    bool cargarSnapshot(const string& ruta, string& error) {
+        Escritura lock(mutex_);
+        ArchivoMapeado m;
+        if (!m.abrir(ruta)) { error = "No se pudo abrir " + ruta; return false; }
+        CabeceraSnapshot cab;
+        if (m.tam() < sizeof(cab)) { error = "Snapshot truncado."; return false; }
+        std::memcpy(&cab, m.datos(), sizeof(cab));
+        if (std::memcmp(cab.magia, "GSNP", 4) != 0 || cab.version != VERSION_SNAPSHOT) {
+            error = "Formato de snapshot desconocido."; return false;
+        }
+        struct Interno {
+            static string cadena(const char* t, uint64_t tam, uint32_t off, bool& ok) {
+                LectorBinario r(t + off, off < tam ? (size_t)(tam - off) : 0);
+                string s = r.cadena();
+                if (!r.ok()) ok = false;
+                return s;
+            }
+            // n registros de 'ancho' bytes desde 'off' caben antes de 'limite' (sin desbordar)
+            static bool cabe(uint64_t off, uint64_t n, uint64_t ancho, uint64_t limite) {
+                return off <= limite && n <= (limite - off) / ancho;
+            }
+        };
+        if (!Interno::cabe(cab.off_cadenas, cab.tam_cadenas, 1, m.tam()) ||
+            !Interno::cabe(cab.off_asignaciones, cab.n_asignaciones, sizeof(AsignacionDisco), m.tam()) ||
+            !Interno::cabe(cab.off_proyectos, cab.n_proyectos, sizeof(ProyectoDisco), cab.off_asignaciones) ||
+            !Interno::cabe(cab.off_empleados, cab.n_empleados, sizeof(EmpleadoDisco), cab.off_proyectos)) {
+            error = "Snapshot truncado."; return false;
+        }
+        const char* tabla = m.datos() + cab.off_cadenas;
+        bool ok = true;
+
+        Diario* guardado = diario_;
+        diario_ = NULL;
+        empleados_.reserve(empleados_.size() + cab.n_empleados);
+        ids_empleados_.reservar(empleados_.size() + cab.n_empleados);
+        Fecha hoy = Fecha::hoy();
+        string rechazo; // de insertar*Validado; el mensaje que se informa es "Snapshot corrupto."
+        for (uint64_t i = 0; i < cab.n_empleados && ok; ++i) {
+            EmpleadoDisco r;
+            std::memcpy(&r, m.datos() + cab.off_empleados + i * sizeof(r), sizeof(r));
+            string carnet = Interno::cadena(tabla, cab.tam_cadenas, r.carnet, ok);
+            string nombre = Interno::cadena(tabla, cab.tam_cadenas, r.nombre, ok);
+            string direccion = Interno::cadena(tabla, cab.tam_cadenas, r.direccion, ok);
+            string telefono = Interno::cadena(tabla, cab.tam_cadenas, r.telefono, ok);
+            string correo = Interno::cadena(tabla, cab.tam_cadenas, r.correo, ok);
+            Fecha nac(r.fecha_nacimiento);
+            if (!ok || carnet.empty() || r.categoria >= (uint32_t)NUM_CATEGORIAS ||
+                !Empleado::validarRestaurado(nac, r.salario, correo, hoy).ok()) {
+                ok = false;
+                break;
+            }
+            Empleado e = Empleado::restaurar(carnet, nombre, nac, (Categoria)r.categoria, r.salario,
+                                             direccion, telefono, correo);
+            ok = insertarEmpleadoValidado(e, rechazo); // carnet o correo repetido
+        }
+        proyectos_.reserve(proyectos_.size() + cab.n_proyectos);
+        ids_proyectos_.reservar(proyectos_.size() + cab.n_proyectos);
+        for (uint64_t i = 0; i < cab.n_proyectos && ok; ++i) {
+            ProyectoDisco r;
+            std::memcpy(&r, m.datos() + cab.off_proyectos + i * sizeof(r), sizeof(r));
+            string codigo = Interno::cadena(tabla, cab.tam_cadenas, r.codigo, ok);
+            string nombre = Interno::cadena(tabla, cab.tam_cadenas, r.nombre, ok);
+            Fecha ini(r.fecha_inicio), fin(r.fecha_finalizacion);
+            // lo mismo que revisa el constructor, sin excepciones
+            if (!ok || codigo.empty() || !Proyecto::validarNombre(nombre).ok() || !Proyecto::validarRango(ini, fin).ok()) {
+                ok = false;
+                break;
+            }
+            Proyecto p(codigo, nombre, ini, fin);
+            ok = insertarProyectoValidado(p, rechazo); // codigo o nombre repetido
+        }
+        asignaciones_.reserve(asignaciones_.size() + cab.n_asignaciones);
+        ids_asignaciones_.reservar(asignaciones_.size() + cab.n_asignaciones);
+        for (uint64_t i = 0; i < cab.n_asignaciones && ok; ++i) {
+            AsignacionDisco r;
+            std::memcpy(&r, m.datos() + cab.off_asignaciones + i * sizeof(r), sizeof(r));
+            if (r.empleado >= empleados_.size() || r.proyecto >= proyectos_.size() ||
+                asignacionExiste(r.empleado, r.proyecto)) {
+                ok = false;
+                break;
+            }
+            insertarAsignacion(r.empleado, r.proyecto, Fecha(r.fecha));
+        }
+        diario_ = guardado;
+        if (!ok) error = "Snapshot corrupto.";
+        return ok;
+    }
+
+    // reproduce un diario sobre el estado actual; devuelve los registros aplicados.
+    // Las operaciones repetidas (ya incluidas en el snapshot) se ignoran.
+    size_t reproducirDiario(const string& ruta) {
+        Escritura lock(mutex_);
+        ArchivoMapeado m;
+        if (!m.abrir(ruta)) return 0;
+        Diario* guardado = diario_;
+        diario_ = NULL;
+        size_t aplicados = 0;
+        LectorBinario r(m.datos(), m.tam());
+        while (!r.fin()) {
+            uint32_t largo = r.u32();
+            if (!r.ok() || largo == 0 || m.tam() - r.pos() < (size_t)largo + 4) break; // cola truncada
+            const char* registro = m.datos() + r.pos();
+            r.saltar(largo);
+            uint32_t suma = r.u32();
+            if (suma != fnv1a(registro, largo)) break;
+
+            LectorBinario c(registro + 1, largo - 1);
+            string error;
+            bool ok = false;
+            switch ((unsigned char)registro[0]) {
+                case DIARIO_EMPLEADO: {
+                    string carnet = c.cadena(), nombre = c.cadena();
+                    Fecha fecha((int32_t)c.u32());
+                    uint32_t cat = c.u32();
+                    double sal = c.f64();
+                    string dir = c.cadena(), tel = c.cadena(), correo = c.cadena();
+                    if (!c.ok() || cat >= (uint32_t)NUM_CATEGORIAS ||
+                        !Empleado::validarRestaurado(fecha, sal, correo, Fecha::hoy()).ok()) break;
+                    Empleado e = Empleado::restaurar(carnet, nombre, fecha, (Categoria)cat, sal, dir, tel, correo);
+                    ok = insertarEmpleadoValidado(e, error);
+                    break;
+                }
+                case DIARIO_PROYECTO: {
+                    string codigo = c.cadena(), nombre = c.cadena();
+                    Fecha ini((int32_t)c.u32()), fin((int32_t)c.u32());
+                    if (!c.ok() || nombre.empty() || fin < ini) break;
+                    Proyecto p(codigo, nombre, ini, fin);
+                    ok = insertarProyectoValidado(p, error);
+                    break;
+                }
+                case DIARIO_ASIGNACION: {
+                    string carnet = c.cadena(), codigo = c.cadena();
+                    Fecha fecha((int32_t)c.u32());
+                    if (!c.ok()) break;
+                    ok = insertarAsignacionPorLlaves(carnet, codigo, fecha, error);
+                    break;
+                }
+                case DIARIO_CORREO: {
+                    string carnet = c.cadena(), correo = c.cadena();
+                    int idxE = buscarEmpleadoPorCarnet(carnet);
+                    if (c.ok() && idxE != -1) ok = aplicarCorreo(idxE, correo, error);
+                    break;
+                }
+                case DIARIO_NOMBRE_PROYECTO: {
+                    string codigo = c.cadena(), nombre = c.cadena();
+                    int idxP = buscarProyectoPorCodigo(codigo);
+                    if (c.ok() && idxP != -1) ok = aplicarNombreProyecto(idxP, nombre, error);
+                    break;
+                }
+                case DIARIO_SALARIO: {
+                    string carnet = c.cadena();
+                    double sal = c.f64();
+                    int idxE = buscarEmpleadoPorCarnet(carnet);
+                    if (c.ok() && idxE != -1) ok = aplicarSalario(idxE, sal, error);
+                    break;
+                }
+                case DIARIO_CATEGORIA: {
+                    string carnet = c.cadena();
+                    uint32_t cat = c.u32();
+                    int idxE = buscarEmpleadoPorCarnet(carnet);
+                    if (c.ok() && idxE != -1 && cat < (uint32_t)NUM_CATEGORIAS)
+                        ok = aplicarCategoria(idxE, categoria_a_texto((Categoria)cat), error);
+                    break;
+                }
+                case DIARIO_BAJA_EMPLEADO: {
+                    string carnet = c.cadena();
+                    int idxE = buscarEmpleadoPorCarnet(carnet);
+                    if (c.ok() && idxE != -1) { quitarEmpleado(idxE); ok = true; }
+                    break;
+                }
+                case DIARIO_BAJA_PROYECTO: {
+                    string codigo = c.cadena();
+                    int idxP = buscarProyectoPorCodigo(codigo);
+                    if (c.ok() && idxP != -1) { quitarProyecto(idxP); ok = true; }
+                    break;
+                }
+                case DIARIO_BAJA_ASIGNACION: {
+                    string carnet = c.cadena(), codigo = c.cadena();
+                    if (c.ok()) ok = quitarAsignacionPorLlaves(carnet, codigo, error);
+                    break;
+                }
+                default:
+                    break;
+            }
+            if (ok) {
+                ++aplicados;
+                recogerSueltas();
+            }
+        }
+        diario_ = guardado;
+        return aplicados;
+    }
+
+    size_t totalProyectos() const { Lectura l(mutex_); return proyectos_.size(); }
+    size_t totalAsignaciones() const { Lectura l(mutex_); return asignaciones_.size(); }
+
+    // bytes ocupados por los registros y el pool de cadenas (benchmark de memoria)
+    void usoMemoria(size_t& empleados, size_t& asignaciones, size_t& cadenas, size_t& frios) const {
+        Lectura l(mutex_);
+        empleados = empleados_.capacity() * sizeof(Empleado);
+        asignaciones = asignaciones_.capacity() * sizeof(Asignacion);
+        cadenas = cadenas_->bytesReservados() + (cadenas_viejas_ ? cadenas_viejas_->bytesReservados() : 0);
+        frios = frio_->bytesEnMemoria() + (frio_viejo_ ? frio_viejo_->bytesEnMemoria() : 0);
+    }
+
+    // direccion y telefono a disco, con una cache LRU de 'capacidad_cache' empleados;
+    // solo con el gestor vacio (los ya archivados quedarian en el pool)
+    bool usarAlmacenFrio(const string& ruta, size_t capacidad_cache, string& error) {
+        Escritura l(mutex_);
+        if (!empleados_.empty()) { error = "El almacen frio se elige antes de cargar empleados."; return false; }
+        if (!frio_->abrir(ruta, capacidad_cache, error)) return false;
+        ruta_frio_ = ruta;
+        cache_frio_ = capacidad_cache;
+        return true;
+    }
+    const AlmacenFrio& almacenFrio() const { return *frio_; }
+
+    // consulta por varios criterios (ver ConsultaEmpleados); ids en orden de alta
+    ResultadoConsulta consultarEmpleados(const ConsultaEmpleados& q, vector<IdRegistro>& ids) const {
+        MedicionOperacion med(estadisticas_, OP_CONSULTAR_EMPLEADOS);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        ResultadoConsulta res = ejecutarConsulta(q, filas);
+        ids.resize(filas.size());
+        for (size_t k = 0; k < filas.size(); ++k) ids[k] = ids_empleados_.id(filas[k]);
+        med.resultado(true);
+        return res;
+    }
+    // la misma consulta formateada, una linea por empleado
+    ResultadoConsulta consultarEmpleados(const ConsultaEmpleados& q, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_CONSULTAR_EMPLEADOS);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        ResultadoConsulta res = ejecutarConsulta(q, filas);
+        for (size_t k = 0; k < filas.size(); ++k) {
+            const Empleado& e = empleados_[filas[k]];
+            out << "- " << e.getCarnet()
+                << " | " << e.getNombre()
+                << " | " << categoria_a_texto(e.getCategoria())
+                << " | " << e.getSalario()
+                << " | " << e.getFechaNacimiento()
+                << " | " << e.getCorreo()
+                << "\n";
+        }
+        med.resultado(true);
+        return res;
+    }
+
+    // busqueda tolerante a errores de tipeo: los k mas parecidos, del mas parecido al menos
+    void buscarAproximado(CampoBusqueda campo, const string& texto, size_t k,
+                          vector<CoincidenciaAproximada>& out) const {
+        MedicionOperacion med(estadisticas_, OP_BUSCAR_APROXIMADO);
+        Lectura l(mutex_);
+        vector<pair<float, size_t> > filas;
+        ejecutarBusqueda(campo, texto, k, filas);
+        const TablaIds& ids = idsDe(campo);
+        out.resize(filas.size());
+        for (size_t i = 0; i < filas.size(); ++i) {
+            out[i].id = ids.id(filas[i].second);
+            out[i].similitud = filas[i].first;
+        }
+        med.resultado(true);
+    }
+    // la misma busqueda formateada, una linea por registro; devuelve los textos revisados
+    size_t buscarAproximado(CampoBusqueda campo, const string& texto, size_t k, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_BUSCAR_APROXIMADO);
+        Lectura l(mutex_);
+        vector<pair<float, size_t> > filas;
+        size_t revisados = ejecutarBusqueda(campo, texto, k, filas);
+        char sim[16];
+        for (size_t i = 0; i < filas.size(); ++i) {
+            std::snprintf(sim, sizeof(sim), "%.2f", filas[i].first);
+            if (campo == BUSQUEDA_NOMBRE_PROYECTO) {
+                const Proyecto& p = proyectos_[filas[i].second];
+                out << "- " << p.getCodigo() << " | " << p.getNombre() << " | " << sim << "\n";
+            } else {
+                const Empleado& e = empleados_[filas[i].second];
+                out << "- " << e.getCarnet() << " | " << e.getNombre() << " | " << e.getCorreo() << " | " << sim << "\n";
+            }
+        }
+        med.resultado(true);
+        return revisados;
+    }
+
+    // ---- ventanas de fechas (limites inclusivos; desde == hasta: un solo dia) ----
+    // proyectos activos algun dia de la ventana, en orden de inicio
+    size_t proyectosActivos(Fecha desde, Fecha hasta, vector<IdRegistro>& ids) const {
+        MedicionOperacion med(estadisticas_, OP_PROYECTOS_ACTIVOS);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        proyectosEnVentana(desde, hasta, filas);
+        ids.resize(filas.size());
+        for (size_t k = 0; k < filas.size(); ++k) ids[k] = ids_proyectos_.id(filas[k]);
+        med.resultado(true);
+        return filas.size();
+    }
+    size_t proyectosActivos(Fecha desde, Fecha hasta, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_PROYECTOS_ACTIVOS);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        proyectosEnVentana(desde, hasta, filas);
+        for (size_t k = 0; k < filas.size(); ++k) {
+            const Proyecto& p = proyectos_[filas[k]];
+            out << "- " << p.getCodigo() << " | " << p.getNombre() << " | " << p.getFechaInicio()
+                << " | " << p.getFechaFinalizacion() << "\n";
+        }
+        med.resultado(true);
+        return filas.size();
+    }
+    // asignaciones hechas en la ventana, por fecha de asignacion
+    size_t asignacionesEntre(Fecha desde, Fecha hasta, vector<AsignacionFechada>& out) const {
+        MedicionOperacion med(estadisticas_, OP_ASIGNACIONES_EN_RANGO);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        asignacionesEnVentana(desde, hasta, filas);
+        out.resize(filas.size());
+        for (size_t k = 0; k < filas.size(); ++k) {
+            const Asignacion& a = asignaciones_[filas[k]];
+            out[k].empleado = ids_empleados_.id(a.empleado);
+            out[k].proyecto = ids_proyectos_.id(a.proyecto);
+            out[k].fecha = a.fecha_asignacion;
+        }
+        med.resultado(true);
+        return filas.size();
+    }
+    size_t asignacionesEntre(Fecha desde, Fecha hasta, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_ASIGNACIONES_EN_RANGO);
+        Lectura l(mutex_);
+        vector<size_t> filas;
+        asignacionesEnVentana(desde, hasta, filas);
+        for (size_t k = 0; k < filas.size(); ++k) {
+            const Asignacion& a = asignaciones_[filas[k]];
+            const Empleado& e = empleados_[a.empleado];
+            const Proyecto& p = proyectos_[a.proyecto];
+            out << "- " << a.fecha_asignacion << " | " << e.getCarnet() << " | " << e.getNombre()
+                << " | " << p.getCodigo() << " | " << p.getNombre() << "\n";
+        }
+        med.resultado(true);
+        return filas.size();
+    }
+    // empleados con dos o mas proyectos activos a la vez dentro de la ventana: solo se
+    // recorren las asignaciones de los proyectos activos en ella. Una linea por empleado
+    // (en orden de alta) con el pico de proyectos simultaneos, cuando empieza y cuales son.
+    // Devuelve la cantidad de empleados sobreasignados.
+    size_t reporteSobreasignacion(Fecha desde, Fecha hasta, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_REPORTE_SOBREASIGNACION);
+        Lectura l(mutex_);
+        vector<size_t> proys;
+        proyectosEnVentana(desde, hasta, proys);
+        // una entrada por asignacion a un proyecto activo, con las llaves de orden ya
+        // resueltas (el orden no salta a las tablas en cada comparacion)
+        struct Par {
+            uint64_t sello_empleado;
+            int32_t ini;             // tramo del proyecto recortado a la ventana
+            int32_t fin;
+            uint64_t sello_proyecto;
+            uint32_t empleado, proyecto;
+        };
+        vector<Par> pares;
+        for (size_t k = 0; k < proys.size(); ++k) {
+            const Proyecto& p = proyectos_[proys[k]];
+            Par x;
+            x.ini = std::max(p.getFechaInicio().dias(), desde.dias());
+            x.fin = std::min(p.getFechaFinalizacion().dias(), hasta.dias());
+            x.sello_proyecto = ids_proyectos_.sello(proys[k]);
+            x.proyecto = (uint32_t)proys[k];
+            const vector<size_t>& lista = asignaciones_por_proyecto_[proys[k]];
+            for (size_t i = 0; i < lista.size(); ++i) {
+                x.empleado = asignaciones_[lista[i]].empleado;
+                x.sello_empleado = ids_empleados_.sello(x.empleado);
+                pares.push_back(x);
+            }
+        }
+        sort(pares.begin(), pares.end(), [](const Par& a, const Par& b) {
+            if (a.sello_empleado != b.sello_empleado) return a.sello_empleado < b.sello_empleado;
+            if (a.ini != b.ini) return a.ini < b.ini;
+            return a.sello_proyecto < b.sello_proyecto;
+        });
+        size_t sobreasignados = 0;
+        vector<const Par*> activos, pico; // proyectos abiertos en el barrido y los del maximo
+        for (size_t g = 0; g < pares.size();) {
+            size_t h = g;
+            while (h < pares.size() && pares[h].empleado == pares[g].empleado) ++h;
+            // barrido por inicio: se cierran los que terminaron antes de que empiece el siguiente
+            activos.clear();
+            pico.clear();
+            int32_t desde_pico = 0;
+            for (size_t k = g; k < h; ++k) {
+                int32_t f = pares[k].ini;
+                activos.erase(remove_if(activos.begin(), activos.end(), [&](const Par* x) { return x->fin < f; }), activos.end());
+                activos.push_back(&pares[k]);
+                if (activos.size() > pico.size()) { pico = activos; desde_pico = f; }
+            }
+            if (pico.size() >= 2) {
+                ++sobreasignados;
+                const Empleado& e = empleados_[pares[g].empleado];
+                out << "- " << e.getCarnet() << " | " << e.getNombre() << " | " << pico.size()
+                    << " simultaneos desde " << Fecha(desde_pico) << " |";
+                for (size_t k = 0; k < pico.size(); ++k) out << (k ? ", " : " ") << proyectos_[pico[k]->proyecto].getCodigo();
+                out << "\n";
+            }
+            g = h;
+        }
+        med.resultado(true);
+        return sobreasignados;
+    }
+
+    // una pagina de cualquier listado, formateada en 'out'.
+    // El cursor no guarda estado del gestor: se puede reanudar despues o en otra sesion.
+    PaginaListado listarPagina(const CursorListado& cur, BufferSalida& out) const {
+        MedicionOperacion med(estadisticas_, OP_LISTAR_PAGINA);
+        Lectura l(mutex_);
+        PaginaListado pag;
+        pag.desde = cur.posicion;
+        size_t tam = cur.tam_pagina ? cur.tam_pagina : 1;
+
+        static const char* titulos[] = {
+            "--- LISTA DE EMPLEADOS", "--- LISTA DE PROYECTOS",
+            "--- EMPLEADOS EN PROYECTO", "--- PROYECTOS DEL EMPLEADO"
+        };
+        BufferSalida filas;
+        long total = formatearRango(cur.tipo, cur.orden, cur.llave, cur.posicion, cur.posicion + tam, filas);
+        pag.encontrado = med.resultado(total >= 0);
+        if (!pag.encontrado) {
+            estadisticas_.rechazo(MOTIVO_NO_ENCONTRADO);
+            out << (cur.tipo == LISTADO_EMPLEADOS_DE_PROYECTO ? "Proyecto no encontrado.\n"
+                                                              : "Empleado no encontrado.\n");
+            pag.total = pag.hasta = 0;
+            pag.hay_anterior = pag.hay_siguiente = false;
+            return pag;
+        }
+        pag.total = (size_t)total;
+        if (pag.desde > pag.total) pag.desde = pag.total;
+        pag.hasta = pag.desde + tam < pag.total ? pag.desde + tam : pag.total;
+        pag.hay_anterior = pag.desde > 0;
+        pag.hay_siguiente = pag.hasta < pag.total;
+
+        out << titulos[cur.tipo];
+        if (!cur.llave.empty() && cur.tipo >= LISTADO_EMPLEADOS_DE_PROYECTO) out << " [" << cur.llave << "]";
+        out << " (" << (pag.total ? pag.desde + 1 : 0) << "-" << pag.hasta << " de " << pag.total << ") ---\n";
+        out << filas.str();
+        out << "==========================\n";
+        return pag;
+    }
+
+    // ---- nomina ----
+    void resumenNomina(ResumenNomina out[NUM_CATEGORIAS]) const {
+        Lectura l(mutex_);
+        columnas_.resumirPorCategoria(Fecha::hoy(), out);
+    }
+    bool resumenNominaProyecto(const string& codigo, ResumenNomina out[NUM_CATEGORIAS]) const {
+        Lectura l(mutex_);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        if (idxP == -1) return false;
+        const vector<size_t>& lista = asignaciones_por_proyecto_[idxP];
+        vector<size_t> filas(lista.size());
+        for (size_t i = 0; i < lista.size(); ++i) filas[i] = asignaciones_[lista[i]].empleado;
+        columnas_.resumirFilas(filas, Fecha::hoy(), out);
+        return true;
+    }
+
+    // reporte de nomina: global por categoria con histograma, y desglose por proyecto
+    // (solo 'codigo' si se indica, todos los proyectos si viene vacio)
+    void reporteNomina(const string& codigo, ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_REPORTE_NOMINA);
+        Lectura l(mutex_);
+        BufferSalida out(&os);
+        Fecha hoy = Fecha::hoy();
+        ResumenNomina r[NUM_CATEGORIAS];
+        if (codigo.empty()) {
+            columnas_.resumirPorCategoria(hoy, r);
+            out << "--- NOMINA POR CATEGORIA ---\n";
+            ResumenNomina total;
+            for (int c = 0; c < NUM_CATEGORIAS; ++c) {
+                escribirFilaNomina(out, categoria_a_texto((Categoria)c).c_str(), r[c]);
+                if (r[c].cantidad == 0) continue;
+                if (total.cantidad == 0 || r[c].minimo < total.minimo) total.minimo = r[c].minimo;
+                if (total.cantidad == 0 || r[c].maximo > total.maximo) total.maximo = r[c].maximo;
+                total.edad_promedio = (total.edad_promedio * total.cantidad + r[c].edad_promedio * r[c].cantidad)
+                                      / (double)(total.cantidad + r[c].cantidad);
+                total.cantidad += r[c].cantidad;
+                total.suma += r[c].suma;
+            }
+            escribirFilaNomina(out, "TOTAL", total);
+            out << "Histograma de salarios (Administrador / Operario / Peon):\n";
+            for (int b = 0; b < BINS_HISTOGRAMA; ++b) {
+                out << "  " << 250000 + b * 25000 << "-" << 275000 + b * 25000 << ": "
+                    << r[0].histograma[b] << " / " << r[1].histograma[b] << " / " << r[2].histograma[b] << "\n";
+            }
+        }
+
+        out << "--- NOMINA POR PROYECTO ---\n";
+        escribirCifrasProyectos(out, codigo);
+        out << "==========================\n";
+        med.resultado(true);
+    }
+
+    // cifras al dia de un proyecto (vista materializada, sin recorrer asignaciones)
+    bool cifrasProyecto(const string& codigo, CifrasProyecto& out) const {
+        Lectura l(mutex_);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        if (idxP == -1) return false;
+        out = cifras_proyecto_[idxP];
+        return true;
+    }
+    // costo de nomina por proyecto (o solo 'codigo'): O(proyectos) sin importar
+    // cuantas asignaciones haya
+    void reporteCostosProyectos(const string& codigo, ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_REPORTE_COSTOS);
+        Lectura l(mutex_);
+        BufferSalida out(&os);
+        out << "--- COSTO DE NOMINA POR PROYECTO ---\n";
+        escribirCifrasProyectos(out, codigo);
+        if (!codigo.empty()) { med.resultado(true); return; }
+        CifrasProyecto total;
+        for (size_t j = 0; j < cifras_proyecto_.size(); ++j) {
+            total.empleados += cifras_proyecto_[j].empleados;
+            total.centimos += cifras_proyecto_[j].centimos;
+            for (int c = 0; c < NUM_CATEGORIAS; ++c) total.por_categoria[c] += cifras_proyecto_[j].por_categoria[c];
+        }
+        out << "TOTAL | " << proyectos_.size() << " proyectos | " << total.empleados << " asignaciones | total "
+            << total.total() << " | Adm/Op/Peon: " << total.por_categoria[0] << "/" << total.por_categoria[1]
+            << "/" << total.por_categoria[2] << "\n";
+        out << "==========================\n";
+        med.resultado(true);
+    }
+
+    // listar empleados
+    void listarEmpleados(ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_LISTAR_EMPLEADOS);
+        Lectura l(mutex_);
+        BufferSalida out(&os);
+        out << "--- LISTA DE EMPLEADOS ---\n";
+        formatearRango(LISTADO_EMPLEADOS, ORDEN_INSERCION, "", 0, empleados_.size(), out);
+        out << "==========================\n";
+        med.resultado(true);
+    }
+
+    // listar proyectos
+    void listarProyectos(ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_LISTAR_PROYECTOS);
+        Lectura l(mutex_);
+        BufferSalida out(&os);
+        out << "--- LISTA DE PROYECTOS ---\n";
+        formatearRango(LISTADO_PROYECTOS, ORDEN_INSERCION, "", 0, proyectos_.size(), out);
+        out << "==========================\n";
+        med.resultado(true);
+    }
+
+    // asignar empleado a proyecto (fecha actual), sin duplicados
+    bool asignarEmpleadoAProyecto(const string& carnet, const string& codigo, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ASIGNAR);
+        Fecha hoy = Fecha::hoy();
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        return med.resultado(confirmado(insertarAsignacionPorLlaves(carnet, codigo, hoy, error), error));
+    }
+
+    // asigna todos los 'carnets' a cada proyecto de 'codigos' (fecha de hoy), todo o nada:
+    // si un proyecto o un carnet no existe no se aplica ninguna asignacion y 'error' los
+    // nombra a todos. Los pares ya asignados y los repetidos del lote se omiten sin fallar.
+    // 'resultados' queda siempre con un par por carnet y proyecto en el orden de entrada
+    // (con false: lo que habria pasado).
+    bool asignarEquipo(const vector<string>& carnets, const vector<string>& codigos,
+                       vector<ResultadoEquipo>& resultados, string& error) {
+        MedicionOperacion med(estadisticas_, OP_ASIGNAR_EQUIPO);
+        Fecha hoy = Fecha::hoy();
+        resultados.clear();
+        Escritura lock(mutex_);
+        if (diarioCaido(error)) return med.resultado(false);
+        // cada proyecto y cada carnet se resuelven una sola vez
+        const int REPETIDO = -2;
+        string faltantes; // "proyecto X, empleado Y, ..."
+        vector<int> idxP(codigos.size());
+        for (size_t j = 0; j < codigos.size(); ++j) {
+            idxP[j] = buscarProyectoPorCodigo(codigos[j]);
+            if (idxP[j] == -1) faltantes += (faltantes.empty() ? "proyecto " : ", proyecto ") + codigos[j];
+            else if (std::find(idxP.begin(), idxP.begin() + j, idxP[j]) != idxP.begin() + j) idxP[j] = REPETIDO;
+        }
+        vector<int> idxE(carnets.size());
+        unordered_set<int> vistos;
+        vistos.reserve(carnets.size());
+        for (size_t i = 0; i < carnets.size(); ++i) {
+            idxE[i] = buscarEmpleadoPorCarnet(carnets[i]);
+            if (idxE[i] == -1) faltantes += (faltantes.empty() ? "empleado " : ", empleado ") + carnets[i];
+            else if (!vistos.insert(idxE[i]).second) idxE[i] = REPETIDO;
+        }
+
+        // una pasada contra las asignaciones existentes; nada cambia hasta confirmar
+        resultados.reserve(carnets.size() * codigos.size());
+        for (size_t j = 0; j < codigos.size(); ++j) {
+            for (size_t i = 0; i < carnets.size(); ++i) {
+                ResultadoEquipo r;
+                r.carnet = (uint32_t)i;
+                r.proyecto = (uint32_t)j;
+                if (idxE[i] == -1 || idxP[j] == -1) r.estado = EQUIPO_NO_ENCONTRADO;
+                else if (idxE[i] == REPETIDO || idxP[j] == REPETIDO) r.estado = EQUIPO_REPETIDO;
+                else if (asignacionExiste(idxE[i], idxP[j])) r.estado = EQUIPO_YA_ASIGNADO;
+                else r.estado = EQUIPO_ASIGNADO;
+                resultados.push_back(r);
+            }
+        }
+        if (!faltantes.empty())
+            return rechazar(MOTIVO_NO_ENCONTRADO, ("No existen: " + faltantes + "; no se asigno nada.").c_str(), error);
+
+        // confirmar: insertarAsignacion no puede fallar; el diario va en un solo fflush.
+        // Sin reserve a la medida: romperia el crecimiento geometrico y cada lote
+        // pagaria un rehash completo de pares_asignados_
+        if (diario_) diario_->iniciarGrupo();
+        for (size_t k = 0; k < resultados.size(); ++k)
+            if (resultados[k].estado == EQUIPO_ASIGNADO)
+                insertarAsignacion(idxE[resultados[k].carnet], idxP[resultados[k].proyecto], hoy);
+        if (diario_) diario_->terminarGrupo();
+        return med.resultado(!diarioCaido(error));
+    }
+
+    // listar empleados asignados a un proyecto
+    void listarEmpleadosDeProyecto(const string& codigo, ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_LISTAR_EMPLEADOS_DE_PROYECTO);
+        Lectura l(mutex_);
+        int idxP = buscarProyectoPorCodigo(codigo);
+        if (idxP == -1) {
+            estadisticas_.rechazo(MOTIVO_NO_ENCONTRADO);
+            os << "Proyecto no encontrado.\n";
+            return;
+        }
+
+        BufferSalida out(&os);
+        out << "--- EMPLEADOS EN PROYECTO [" << codigo << "] ---\n";
+        formatearRango(LISTADO_EMPLEADOS_DE_PROYECTO, ORDEN_INSERCION, codigo, 0,
+                       asignaciones_por_proyecto_[idxP].size(), out);
+        out << "=============================================\n";
+        med.resultado(true);
+    }
+
+    // listar proyectos en los que trabaja un empleado
+    void listarProyectosDeEmpleado(const string& carnet, ostream& os) const {
+        MedicionOperacion med(estadisticas_, OP_LISTAR_PROYECTOS_DE_EMPLEADO);
+        Lectura l(mutex_);
+        int idxE = buscarEmpleadoPorCarnet(carnet);
+        if (idxE == -1) {
+            estadisticas_.rechazo(MOTIVO_NO_ENCONTRADO);
+            os << "Empleado no encontrado.\n";
+            return;
+        }
+
+        BufferSalida out(&os);
+        out << "--- PROYECTOS DEL EMPLEADO [" << carnet << "] ---\n";
+        formatearRango(LISTADO_PROYECTOS_DE_EMPLEADO, ORDEN_INSERCION, carnet, 0,
+                       asignaciones_por_empleado_[idxE].size(), out);
+        out << "=============================================\n";
+        med.resultado(true);
+    }
+
+    // ---- estadisticas de operaciones (no toman el candado: solo atomicos) ----
+    void imprimirEstadisticas(ostream& os) const {
+        estadisticas_.imprimir(os);
+        if (frio_->fallo() || (frio_viejo_ && frio_viejo_->fallo()))
+            os << "Aviso: el almacen frio tuvo errores de E/S (los registros sin escribir siguen en memoria).\n";
+    }
+    void volcarEstadisticas(ostream& os) const { estadisticas_.volcarJson(os); }
+    void reiniciarEstadisticas() { estadisticas_.reiniciar(); }
+};
+
+
+// directorio de datos: snapshot + diario; la compactacion corre en segundo plano
+class Persistencia {
+private:
+    string dir_;
+    Diario diario_;
+    thread hilo_;
+    atomic<bool> compactando_;
+    size_t umbral_; // entradas de diario que disparan una compactacion automatica
+
+    string rutaSnapshot() const { return dir_ + "/gestor.snap"; }
+    string rutaDiario() const { return dir_ + "/gestor.wal"; }
+    string rutaDiarioViejo() const { return dir_ + "/gestor.wal.old"; }
+
+    void esperarHilo() { if (hilo_.joinable()) hilo_.join(); }
+
+public:
+    explicit Persistencia(const string& dir, size_t umbral = 100000)
+        : dir_(dir), compactando_(false), umbral_(umbral) {}
+    ~Persistencia() { esperarHilo(); }
+
+    // carga snapshot + diarios pendientes y conecta el diario al gestor
+    bool abrir(GestorSistema& gs, string& error) {
+        if (!crear_directorio(dir_)) { error = "No se pudo crear el directorio " + dir_; return false; }
+        FILE* f = fopen(rutaSnapshot().c_str(), "rb");
+        if (f) {
+            fclose(f);
+            if (!gs.cargarSnapshot(rutaSnapshot(), error)) return false;
+        }
+        gs.reproducirDiario(rutaDiarioViejo()); // compactacion interrumpida
+        gs.reproducirDiario(rutaDiario());
+        if (!diario_.abrir(rutaDiario())) { error = "No se pudo abrir el diario."; return false; }
+        gs.conectarDiario(&diario_);
+        return true;
+    }
+
+    // rota el diario y escribe el snapshot en un hilo aparte; false si ya hay una en curso
+    bool compactar(GestorSistema& gs) {
+        if (compactando_.load()) return false;
+        esperarHilo();
+        std::shared_ptr<GestorSistema::Imagen> img(new GestorSistema::Imagen());
+        if (!gs.capturarImagenYRotar(*img, rutaDiarioViejo())) return false;
+        compactando_.store(true);
+        string snap = rutaSnapshot(), viejo = rutaDiarioViejo();
+        hilo_ = thread([this, img, snap, viejo]() {
+            string error;
+            // el diario viejo solo se borra cuando el snapshot nuevo ya esta en su lugar;
+            // si la escritura falla se conserva y se reproduce en el proximo arranque
+            if (GestorSistema::escribirSnapshot(*img, snap, error)) std::remove(viejo.c_str());
+            compactando_.store(false);
+        });
+        return true;
+    }
+
+    void compactarSiHaceFalta(GestorSistema& gs) {
+        if (diario_.entradas() >= umbral_) compactar(gs);
+    }
+    bool compactando() const { return compactando_.load(); }
+
+    // compactacion sincronica al salir
+    void cerrar(GestorSistema& gs) {
+        esperarHilo();
+        if (diario_.entradas() > 0) compactar(gs);
+        esperarHilo();
+        diario_.cerrar();
+    }
+};
+
+
+static void pausar() {
+    cout << "Presione ENTER para continuar...";
+    cin.ignore(10000, '\n');
+}
+
+// al terminar la entrada devuelve vacio y deja cin en fallo: cada formulario lo revisa
+// antes de aplicar nada y el menu termina
+static string leer_linea(const string& prompt) {
+    cout << prompt;
+    string s;
+    if (!getline(cin, s)) s.clear();
+    return s;
+}
+
+// false al terminar la entrada (no se vuelve a preguntar: no habra respuesta)
+static bool leer_double(const string& prompt, double& val) {
+    while (true) {
+        cout << prompt;
+        string s;
+        if (!getline(cin, s)) return false;
+        if (std::sscanf(s.c_str(), "%lf", &val) == 1) return true;
+        cout << "Entrada invalida, intente de nuevo.\n";
+    }
+}
+
+static int leer_opcion() {
+    string s;
+    if (!getline(cin, s)) return 0; // fin de la entrada: se sale como con la opcion 0
+    int op = -1;
+    std::sscanf(s.c_str(), "%d", &op);
+    return op;
+}
+
+
+// ---- benchmark: busqueda indexada vs busqueda lineal anterior ----
+static double segundos_desde(const chrono::steady_clock::time_point& t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static string carnet_sintetico(size_t i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "C%08lu", (unsigned long)i);
+    return string(buf);
+}
+
+static void benchmark_indices(size_t n, size_t consultas) {
+    cout << "--- BENCHMARK DE INDICES (n=" << n << ", consultas=" << consultas << ") ---\n";
+    GestorSistema gs;
+    vector<string> carnets; // copia para emular la busqueda lineal de antes
+    carnets.reserve(n);
+    string error;
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        string c = carnet_sintetico(i);
+        gs.crearEmpleado(c, "Empleado " + c, "1990-01-01", "Operario",
+                         "", "8888-0000", c + "@empresa.com", error);
+        carnets.push_back(c);
+    }
+    cout << "Alta de " << n << " empleados: " << segundos_desde(t0) << " s\n";
+
+    // mezcla de aciertos y fallos
+    vector<string> llaves;
+    for (size_t i = 0; i < consultas; ++i)
+        llaves.push_back(carnet_sintetico((i * 7919u) % (2 * n)));
+
+    size_t hits_hash = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < llaves.size(); ++i)
+        if (gs.existeEmpleado(llaves[i])) ++hits_hash;
+    double t_hash = segundos_desde(t0);
+
+    size_t hits_lineal = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < llaves.size(); ++i) {
+        for (size_t j = 0; j < carnets.size(); ++j)
+            if (carnets[j] == llaves[i]) { ++hits_lineal; break; }
+    }
+    double t_lineal = segundos_desde(t0);
+
+    cout << "Busqueda hash:   " << t_hash * 1e9 / consultas << " ns/consulta (aciertos " << hits_hash << ")\n";
+    cout << "Busqueda lineal: " << t_lineal * 1e9 / consultas << " ns/consulta (aciertos " << hits_lineal << ")\n";
+    if (t_hash > 0) cout << "Aceleracion: x" << t_lineal / t_hash << "\n";
+}
+
+// ---- benchmark: importacion masiva desde CSV ----
+static void escribir_empleados_sinteticos(ostream& out, size_t n) {
+    const char* categorias[] = { "Administrador", "Operario", "Peon" };
+    out << "carnet,nombre,fecha_nacimiento,categoria,salario,direccion,telefono,correo\n";
+    char fecha[16];
+    for (size_t i = 0; i < n; ++i) {
+        string c = carnet_sintetico(i);
+        std::snprintf(fecha, sizeof(fecha), "%04d-%02d-%02d",
+                      1960 + (int)(i % 40), 1 + (int)(i % 12), 1 + (int)(i % 28));
+        out << c << ",Empleado " << c << "," << fecha << "," << categorias[i % 3] << ","
+            << 250000 + (i * 37) % 250001 << ",,8888-0000," << c << "@empresa.com\n";
+    }
+}
+
+static void benchmark_importacion(size_t n, unsigned hilos, const string& ruta) {
+    cout << "--- BENCHMARK DE IMPORTACION (n=" << n << ", hilos=" << hilos << ") ---\n";
+    {
+        ofstream out(ruta.c_str(), ios::out | ios::binary);
+        escribir_empleados_sinteticos(out, n);
+    }
+    GestorSistema gs;
+    ReporteImportacion rep;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    gs.importarArchivo(IMPORTAR_EMPLEADOS, ruta, rep, hilos);
+    double t = segundos_desde(t0);
+    cout << "Importadas " << rep.aceptadas << " de " << rep.leidas << " filas en " << t << " s ("
+         << (t > 0 ? rep.leidas / t : 0.0) << " filas/s), rechazadas: " << rep.errores.size() << "\n";
+    std::remove(ruta.c_str());
+}
+
+// ---- benchmark: exportacion masiva contra el listado de texto ----
+static void benchmark_exportacion(size_t n, unsigned hilos) {
+    cout << "--- BENCHMARK DE EXPORTACION (n=" << n << ", hilos=" << hilos << ") ---\n";
+    GestorSistema gs;
+    {
+        stringstream emps, proys, asigs;
+        escribir_empleados_sinteticos(emps, n);
+        proys << "codigo,nombre,fecha_inicio,fecha_finalizacion\n";
+        for (size_t p = 0; p < 100; ++p) proys << "PRY-" << p << ",Proyecto numero " << p << ",2024-01-01,2025-12-31\n";
+        asigs << "carnet,codigo,fecha_asignacion\n";
+        for (size_t i = 0; i < n; ++i) asigs << carnet_sintetico(i) << ",PRY-" << i % 100 << ",2024-06-01\n";
+        ReporteImportacion rep;
+        gs.importar(IMPORTAR_EMPLEADOS, emps, false, rep);
+        gs.importar(IMPORTAR_PROYECTOS, proys, false, rep);
+        gs.importar(IMPORTAR_ASIGNACIONES, asigs, false, rep);
+    }
+    const string ruta = "bench_exportacion.tmp";
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    {
+        ofstream out(ruta.c_str(), ios::out | ios::binary);
+        gs.listarEmpleados(out);
+    }
+    double t = segundos_desde(t0);
+    cout << "Listado de texto (mostrar):  " << t << " s (" << (t > 0 ? n / t : 0.0) << " filas/s)\n";
+    static const char* tipos[] = { "empleados", "proyectos", "asignaciones" };
+    for (int tipo = 0; tipo < 3; tipo += 2) {
+        for (int jsonl = 0; jsonl < 2; ++jsonl) {
+            string archivo = ruta + (jsonl ? ".jsonl" : ".csv");
+            ReporteExportacion rep;
+            t0 = chrono::steady_clock::now();
+            gs.exportarArchivo((TipoExportacion)tipo, archivo, rep, hilos);
+            t = segundos_desde(t0);
+            cout << "Exportar " << tipos[tipo] << (jsonl ? " JSONL: " : " CSV:   ") << t << " s ("
+                 << (t > 0 ? rep.filas / t : 0.0) << " filas/s, " << (t > 0 ? rep.bytes / t / 1e6 : 0.0) << " MB/s)";
+            if (tipo == EXPORTAR_EMPLEADOS) { // ida y vuelta: el archivo se vuelve a importar completo
+                GestorSistema copia;
+                ReporteImportacion ri;
+                copia.importarArchivo(IMPORTAR_EMPLEADOS, archivo, ri, hilos);
+                cout << ", reimportadas " << ri.aceptadas << "/" << rep.filas;
+            }
+            cout << "\n";
+            std::remove(archivo.c_str());
+        }
+    }
+    std::remove(ruta.c_str());
+}
+
+static void benchmark_nomina(size_t n, size_t repeticiones) {
+    cout << "--- BENCHMARK DE NOMINA (n=" << n << ") ---\n";
+    GestorSistema gs;
+    {
+        stringstream datos;
+        escribir_empleados_sinteticos(datos, n);
+        ReporteImportacion rep;
+        gs.importar(IMPORTAR_EMPLEADOS, datos, false, rep);
+    }
+    ResumenNomina r[NUM_CATEGORIAS];
+    double suma = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < repeticiones; ++k) {
+        gs.resumenNomina(r);
+        suma += r[0].suma + r[1].suma + r[2].suma;
+    }
+    double t = segundos_desde(t0);
+    cout << "Resumen por categoria: " << (t * 1000.0 / repeticiones) << " ms por reporte ("
+         << gs.totalEmpleados() << " empleados, total " << (size_t)(suma / repeticiones) << ")\n";
+}
+
+// bytes en uso en el heap (0 si la plataforma no lo informa)
+static size_t bytes_en_heap() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// compara la representacion anterior (un std::string por campo, carnet y codigo
+// copiados en cada asignacion) con la actual (vistas a un pool internado); con
+// 'ruta_frio' la direccion y el telefono van a disco (ver AlmacenFrio)
+static void benchmark_memoria(size_t n, const string& ruta_frio) {
+    const size_t proyectos = 100, por_empleado = 2;
+    cout << "--- BENCHMARK DE MEMORIA (n=" << n << ", " << por_empleado << " asignaciones por empleado) ---\n";
+    stringstream emps, proys, asigs;
+    escribir_empleados_sinteticos(emps, n);
+    proys << "codigo,nombre,fecha_inicio,fecha_finalizacion\n";
+    for (size_t p = 0; p < proyectos; ++p)
+        proys << "PRY-" << p << ",Proyecto numero " << p << ",2024-01-01,2025-12-31\n";
+    asigs << "carnet,codigo,fecha_asignacion\n";
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < por_empleado; ++k)
+            asigs << carnet_sintetico(i) << ",PRY-" << (i + k * 37) % proyectos << ",2024-06-01\n";
+
+    // antes: registros con std::string por campo
+    struct EmpleadoPlano {
+        string carnet, nombre;
+        Fecha nacimiento;
+        Categoria categoria;
+        double salario;
+        string direccion, telefono, correo;
+    };
+    struct AsignacionPlana {
+        string carnet, codigo;
+        Fecha fecha;
+        size_t empleado, proyecto;
+    };
+    size_t base = bytes_en_heap();
+    size_t antes_emp = 0, antes_asig = 0;
+    {
+        vector<EmpleadoPlano> ve(n);
+        for (size_t i = 0; i < n; ++i) {
+            string c = carnet_sintetico(i);
+            ve[i].carnet = c;
+            ve[i].nombre = "Empleado " + c;
+            ve[i].categoria = (Categoria)(i % 3);
+            ve[i].salario = 250000.0;
+            ve[i].direccion = "San Jose";
+            ve[i].telefono = "8888-0000";
+            ve[i].correo = c + "@empresa.com";
+        }
+        antes_emp = bytes_en_heap() - base;
+        vector<AsignacionPlana> va(n * por_empleado);
+        for (size_t i = 0; i < va.size(); ++i) {
+            va[i].carnet = ve[i / por_empleado].carnet;
+            char cod[24];
+            std::snprintf(cod, sizeof(cod), "PRY-%lu", (unsigned long)((i / por_empleado + (i % por_empleado) * 37) % proyectos));
+            va[i].codigo = cod;
+            va[i].empleado = i / por_empleado;
+            va[i].proyecto = 0;
+        }
+        antes_asig = bytes_en_heap() - base - antes_emp;
+    }
+
+    // ahora: GestorSistema completo (registros, pool, indices, registros unicos, adyacencia)
+    base = bytes_en_heap();
+    GestorSistema gs;
+    if (!ruta_frio.empty()) {
+        string error;
+        if (!gs.usarAlmacenFrio(ruta_frio, 1000, error)) { cout << error << "\n"; return; }
+    }
+    ReporteImportacion rep;
+    gs.importar(IMPORTAR_EMPLEADOS, emps, false, rep);
+    gs.importar(IMPORTAR_PROYECTOS, proys, false, rep);
+    gs.importar(IMPORTAR_ASIGNACIONES, asigs, false, rep);
+    size_t total = bytes_en_heap() - base;
+    size_t reg_emp = 0, reg_asig = 0, pool = 0, frios = 0;
+    gs.usoMemoria(reg_emp, reg_asig, pool, frios);
+
+    if (base == 0 && total == 0) { cout << "(la plataforma no informa el uso del heap)\n"; return; }
+    double ne = (double)gs.totalEmpleados(), na = (double)gs.totalAsignaciones();
+    if (ne == 0 || na == 0) { cout << "No se generaron datos.\n"; return; }
+    cout << "Antes, registros de empleado:   " << antes_emp / ne << " bytes/empleado\n";
+    cout << "Antes, registros de asignacion: " << antes_asig / na << " bytes/asignacion\n";
+    cout << "Ahora, registros de empleado:   " << (reg_emp + pool) / ne << " bytes/empleado"
+         << " (" << sizeof(Empleado) << " por registro + pool de " << pool << " bytes)\n";
+    cout << "Ahora, registros de asignacion: " << reg_asig / na << " bytes/asignacion\n";
+    cout << "Ahora, direccion y telefono:    " << frios / ne << " bytes/empleado en memoria";
+    if (gs.almacenFrio().enDisco()) cout << " (" << gs.almacenFrio().bytesEnDisco() / ne << " en disco)";
+    cout << "\n";
+    cout << "Gestor completo (con indices):  " << total / ne << " bytes/empleado\n";
+}
+
+// ---- prueba de estres: varios hilos sobre un mismo gestor ----
+// mezcla: 60% busquedas por carnet, 26% paginas de listado, 2% busquedas aproximadas,
+// 5% altas propias, 5% altas disputadas (todos los hilos compiten por las mismas
+// llaves: solo una debe ganar) y 2% bajas
+static void benchmark_concurrencia(size_t operaciones) {
+    const size_t base = 20000, disputadas = 500;
+    const unsigned hilos_prueba[] = { 1, 4, 16 };
+    cout << "--- PRUEBA DE ESTRES CONCURRENTE (" << operaciones << " operaciones, base de "
+         << base << " empleados) ---\n";
+    for (size_t h = 0; h < sizeof(hilos_prueba) / sizeof(hilos_prueba[0]); ++h) {
+        const unsigned hilos = hilos_prueba[h];
+        GestorSistema gs;
+        {
+            stringstream datos;
+            escribir_empleados_sinteticos(datos, base);
+            ReporteImportacion rep;
+            gs.importar(IMPORTAR_EMPLEADOS, datos, false, rep);
+        }
+        atomic<size_t> altas(0), ganadas(0), bajas(0), encontrados(0);
+        vector<thread> trabajadores;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (unsigned t = 0; t < hilos; ++t) {
+            trabajadores.push_back(thread([&, t]() {
+                size_t mias = operaciones / hilos + (t < operaciones % hilos ? 1 : 0);
+                unsigned long long x = 88172645463325252ULL ^ ((unsigned long long)(t + 1) << 32);
+                BufferSalida out;
+                CursorListado cur;
+                string error;
+                char carnet[32];
+                for (size_t i = 0; i < mias; ++i) {
+                    x ^= x << 13; x ^= x >> 7; x ^= x << 17; // xorshift64
+                    size_t r = (size_t)(x % 100), k = (size_t)(x >> 16);
+                    if (r < 60) {
+                        if (gs.existeEmpleado(carnet_sintetico(k % base))) ++encontrados;
+                    } else if (r < 86) {
+                        cur.orden = (OrdenListado)(k % NUM_ORDENES);
+                        cur.posicion = (k >> 8) % base;
+                        out.limpiar();
+                        gs.listarPagina(cur, out);
+                    } else if (r < 88) {
+                        // la primera busqueda arma el indice mientras otros hilos leen
+                        out.limpiar();
+                        gs.buscarAproximado(BUSQUEDA_CORREO_EMPLEADO, carnet_sintetico(k % base) + "@empresa.con", 5, out);
+                    } else if (r < 93) {
+                        std::snprintf(carnet, sizeof(carnet), "H%02u-%08lu", t, (unsigned long)i);
+                        string c(carnet);
+                        if (gs.crearEmpleado(c, "Hilo " + c, "1990-01-01", "Peon", "", "8888-0000",
+                                             c + "@hilos.com", error))
+                            ++altas;
+                    } else if (r < 98) {
+                        string c = carnet_sintetico(base + k % disputadas);
+                        if (gs.crearEmpleado(c, "Disputado " + c, "1990-01-01", "Operario", "", "8888-0000",
+                                             c + "@empresa.com", error)) {
+                            ++altas;
+                            ++ganadas;
+                        }
+                    } else {
+                        // las bajas mueven registros mientras otros hilos paginan
+                        if (gs.eliminarEmpleado(carnet_sintetico(base + k % disputadas), error)) ++bajas;
+                    }
+                }
+            }));
+        }
+        for (size_t t = 0; t < trabajadores.size(); ++t) trabajadores[t].join();
+        double seg = segundos_desde(t0);
+        bool ok = gs.consistente() && gs.totalEmpleados() == base + altas.load() - bajas.load() &&
+                  ganadas.load() - bajas.load() <= disputadas;
+        cout << hilos << " hilos: " << seg << " s, " << (seg > 0 ? operaciones / seg : 0.0) << " ops/s, "
+             << altas.load() << " altas (" << ganadas.load() << " disputadas), " << bajas.load() << " bajas, invariantes "
+             << (ok ? "OK" : "FALLAN") << "\n";
+    }
+}
+
+// ---- suite de benchmarks con datos sinteticos deterministicos ----
+// misma semilla -> mismos empleados, proyectos y grafo de asignaciones
+class GeneradorSintetico {
+private:
+    unsigned long long estado_;
+
+public:
+    explicit GeneradorSintetico(unsigned long long semilla) : estado_(semilla) {}
+
+    unsigned long long siguiente() { // splitmix64
+        unsigned long long z = (estado_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    size_t rango(size_t n) { return (size_t)(siguiente() % n); }
+
+    struct DatosEmpleado {
+        string carnet, nombre, fecha_nacimiento, categoria, direccion, telefono, correo;
+        double salario;
+    };
+    // carnet y correo se derivan de i (unicos); el resto es aleatorio pero valido
+    void empleado(size_t i, DatosEmpleado& d) {
+        static const char* nombres[] = { "Ana", "Luis", "Maria", "Jose", "Carla", "Diego", "Sofia", "Pablo" };
+        static const char* apellidos[] = { "Mora", "Rojas", "Vargas", "Solis", "Jimenez", "Castro", "Araya", "Chaves" };
+        static const char* direcciones[] = { "", "Heredia", "Cartago", "Alajuela", "Liberia", "Limon", "Puntarenas", "Escazu" };
+        static const char* categorias[] = { "Administrador", "Operario", "Peon" };
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "E%09lu", (unsigned long)i);
+        d.carnet = buf;
+        d.nombre = string(nombres[rango(8)]) + " " + apellidos[rango(8)] + " " + apellidos[rango(8)];
+        int anio = 1960 + (int)rango(40), mes = 1 + (int)rango(12);
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", anio, mes, 1 + (int)rango((size_t)dias_del_mes(anio, mes)));
+        d.fecha_nacimiento = buf;
+        d.categoria = categorias[rango(3)];
+        d.salario = 250000.0 + (double)rango(250001);
+        d.direccion = direcciones[rango(8)];
+        std::snprintf(buf, sizeof(buf), "8%03lu-%04lu", (unsigned long)rango(1000), (unsigned long)rango(10000));
+        d.telefono = buf;
+        std::snprintf(buf, sizeof(buf), "e%lu@empresa.com", (unsigned long)i);
+        d.correo = buf;
+    }
+    void proyecto(size_t j, string& codigo, string& nombre, string& inicio, string& fin) {
+        char buf[48];
+        std::snprintf(buf, sizeof(buf), "P%06lu", (unsigned long)j);
+        codigo = buf;
+        nombre = "Proyecto " + codigo;
+        int anio = 2015 + (int)rango(10), mes = 1 + (int)rango(12);
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-01", anio, mes);
+        inicio = buf;
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-28", anio + 1 + (int)rango(3), mes);
+        fin = buf;
+    }
+};
+
+// streambuf que descarta todo: mide el formateo de los listados sin la terminal
+class DescarteBuf : public streambuf {
+protected:
+    int overflow(int c) { return c == EOF ? 0 : c; }
+    streamsize xsputn(const char*, streamsize n) { return n; }
+};
+
+// una linea JSON por medicion
+static void reportar_medicion(ostream& out, const char* op, size_t n, size_t fanout,
+                              size_t repeticiones, double segundos) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"op\":\"%s\",\"n\":%lu,\"fanout\":%lu,\"reps\":%lu,\"s\":%.6f,\"ns_op\":%.1f}\n",
+                  op, (unsigned long)n, (unsigned long)fanout, (unsigned long)repeticiones, segundos,
+                  repeticiones ? segundos * 1e9 / (double)repeticiones : 0.0);
+    out << buf << flush;
+}
+
+// escalas 10^3 .. max_n; cada escala: n empleados, max(10, n/100) proyectos y
+// 'fanout' asignaciones por empleado
+static void benchmark_suite(size_t max_n, size_t fanout, unsigned long long semilla, ostream& out) {
+    DescarteBuf descarte_buf;
+    ostream descarte(&descarte_buf);
+    string error;
+    {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "{\"suite\":\"gestor\",\"version\":1,\"semilla\":%llu,\"max_n\":%lu,\"fanout\":%lu}\n",
+                      semilla, (unsigned long)max_n, (unsigned long)fanout);
+        out << buf;
+    }
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        GeneradorSintetico gen(semilla);
+        GestorSistema gs;
+        const size_t m = n / 100 > 10 ? n / 100 : 10;
+        const size_t f = fanout < m ? fanout : m;
+
+        vector<GeneradorSintetico::DatosEmpleado> emps(n);
+        for (size_t i = 0; i < n; ++i) gen.empleado(i, emps[i]);
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) {
+            const GeneradorSintetico::DatosEmpleado& e = emps[i];
+            gs.crearEmpleado(e.carnet, e.nombre, e.fecha_nacimiento, e.categoria, e.salario,
+                             e.direccion, e.telefono, e.correo, error);
+        }
+        reportar_medicion(out, "crear_empleado", n, f, n, segundos_desde(t0));
+
+        vector<string> codigos(m);
+        t0 = chrono::steady_clock::now();
+        for (size_t j = 0; j < m; ++j) {
+            string nombre, inicio, fin;
+            gen.proyecto(j, codigos[j], nombre, inicio, fin);
+            gs.crearProyecto(codigos[j], nombre, inicio, fin, error);
+        }
+        reportar_medicion(out, "crear_proyecto", n, f, m, segundos_desde(t0));
+
+        // cada empleado a f proyectos consecutivos desde uno al azar (siempre distintos)
+        vector<size_t> primero(n);
+        for (size_t i = 0; i < n; ++i) primero[i] = gen.rango(m);
+        t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            for (size_t k = 0; k < f; ++k)
+                gs.asignarEmpleadoAProyecto(emps[i].carnet, codigos[(primero[i] + k) % m], error);
+        reportar_medicion(out, "asignar", n, f, n * f, segundos_desde(t0));
+
+        const size_t q = n < 200000 ? n : 200000;
+        vector<string> llaves(q);
+        for (size_t k = 0; k < q; ++k)
+            llaves[k] = (k & 1) ? emps[gen.rango(n)].carnet : "X" + emps[gen.rango(n)].carnet; // mitad fallos
+        size_t hallados = 0;
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < q; ++k) hallados += gs.existeEmpleado(llaves[k]);
+        reportar_medicion(out, "existe_empleado", n, f, q, segundos_desde(t0));
+        if (hallados != q / 2) cerr << "Aviso: busquedas inconsistentes (" << hallados << ")\n";
+
+        size_t reps = 100000 / n ? 100000 / n : 1;
+        t0 = chrono::steady_clock::now();
+        for (size_t r = 0; r < reps; ++r) gs.listarEmpleados(descarte);
+        reportar_medicion(out, "listar_empleados", n, f, reps, segundos_desde(t0));
+
+        static const char* nombres_orden[NUM_ORDENES] = {
+            "pagina_insercion", "pagina_llave", "pagina_nombre", "pagina_salario", "pagina_fecha"
+        };
+        BufferSalida pagina;
+        for (int o = 0; o < NUM_ORDENES; ++o) {
+            CursorListado cur;
+            cur.orden = (OrdenListado)o;
+            t0 = chrono::steady_clock::now();
+            gs.listarPagina(cur, pagina); // primera pagina: incluye construir la permutacion
+            reportar_medicion(out, (string(nombres_orden[o]) + "_fria").c_str(), n, f, 1, segundos_desde(t0));
+            const size_t paginas = 5000;
+            t0 = chrono::steady_clock::now();
+            for (size_t k = 0; k < paginas; ++k) {
+                cur.posicion = gen.rango(n);
+                pagina.limpiar();
+                gs.listarPagina(cur, pagina);
+            }
+            reportar_medicion(out, nombres_orden[o], n, f, paginas, segundos_desde(t0));
+        }
+
+        const size_t qp = 2000;
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < qp; ++k) gs.listarEmpleadosDeProyecto(codigos[gen.rango(m)], descarte);
+        reportar_medicion(out, "empleados_de_proyecto", n, f, qp, segundos_desde(t0));
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < q; ++k) gs.listarProyectosDeEmpleado(emps[gen.rango(n)].carnet, descarte);
+        reportar_medicion(out, "proyectos_de_empleado", n, f, q, segundos_desde(t0));
+
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < q; ++k)
+            gs.cambiarSalarioEmpleado(emps[gen.rango(n)].carnet, 250000.0 + (double)gen.rango(250001), error);
+        reportar_medicion(out, "cambiar_salario", n, f, q, segundos_desde(t0));
+
+        const size_t rn = 20;
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < rn; ++k) gs.reporteNomina("", descarte);
+        reportar_medicion(out, "reporte_nomina", n, f, rn, segundos_desde(t0));
+        t0 = chrono::steady_clock::now();
+        for (size_t k = 0; k < rn; ++k) gs.reporteCostosProyectos("", descarte);
+        reportar_medicion(out, "reporte_costos", n, f, rn, segundos_desde(t0));
+
+        // consultas por criterios: la primera de cada tipo construye sus indices (fria)
+        static const char* nombres_consulta[] = {
+            "consulta_salario", "consulta_nacimiento", "consulta_nombre", "consulta_correo", "consulta_combinada"
+        };
+        vector<IdRegistro> hallados_q;
+        for (int tipo = 0; tipo < 5; ++tipo) {
+            const size_t qc = 200;
+            for (size_t k = 0; k <= qc; ++k) {
+                ConsultaEmpleados cq;
+                const GeneradorSintetico::DatosEmpleado& e = emps[gen.rango(n)];
+                if (tipo == 0) { cq.salario_min = e.salario; cq.salario_max = e.salario + 100.0; }
+                else if (tipo == 1) Fecha::parsear(e.fecha_nacimiento, cq.nacido_desde), cq.nacido_hasta = cq.nacido_desde;
+                else if (tipo == 2) cq.prefijo_nombre = e.nombre;
+                else if (tipo == 3) cq.prefijo_correo = e.correo.substr(0, e.correo.find('@'));
+                else {
+                    // "Operarios con mas de 400000, nacidos antes de 1980, cuyo nombre empieza con Mar"
+                    cq.filtrarCategoria(CATEGORIA_OPERARIO);
+                    cq.salario_min = 400000.0;
+                    cq.nacido_hasta = Fecha::desdeCivil(1979, 12, 31);
+                    cq.prefijo_nombre = "Mar";
+                }
+                if (k == 0) t0 = chrono::steady_clock::now();
+                gs.consultarEmpleados(cq, hallados_q);
+                if (k == 0) {
+                    reportar_medicion(out, (string(nombres_consulta[tipo]) + "_fria").c_str(), n, f, 1, segundos_desde(t0));
+                    t0 = chrono::steady_clock::now();
+                }
+            }
+            reportar_medicion(out, nombres_consulta[tipo], n, f, qc, segundos_desde(t0));
+        }
+
+        // busqueda aproximada con un error de tipeo (dos letras vecinas cambiadas);
+        // la primera de cada campo construye su indice de trigramas (fria)
+        vector<CoincidenciaAproximada> hallados_b;
+        for (int c = 0; c < NUM_CAMPOS_BUSQUEDA; ++c) {
+            const size_t qb = 200;
+            for (size_t k = 0; k <= qb; ++k) {
+                const GeneradorSintetico::DatosEmpleado& e = emps[gen.rango(n)];
+                string texto = c == BUSQUEDA_NOMBRE_EMPLEADO ? e.nombre
+                             : c == BUSQUEDA_CORREO_EMPLEADO ? e.correo : "Proyecto " + codigos[gen.rango(m)];
+                size_t p = gen.rango(texto.size() - 1);
+                std::swap(texto[p], texto[p + 1]);
+                if (k == 0) t0 = chrono::steady_clock::now();
+                gs.buscarAproximado((CampoBusqueda)c, texto, 10, hallados_b);
+                if (k == 0) {
+                    reportar_medicion(out, (string("buscar_") + NOMBRES_CAMPO_BUSQUEDA[c] + "_fria").c_str(), n, f, 1, segundos_desde(t0));
+                    t0 = chrono::steady_clock::now();
+                }
+            }
+            reportar_medicion(out, (string("buscar_") + NOMBRES_CAMPO_BUSQUEDA[c]).c_str(), n, f, qb, segundos_desde(t0));
+        }
+
+        // ventanas de fechas: un dia al azar (proyectos activos), un mes al azar (sobreasignacion)
+        // y un dia del pasado para las asignaciones, que en la suite son todas de hoy (mide la busqueda)
+        BufferSalida ventana;
+        for (int tipo = 0; tipo < 3; ++tipo) {
+            static const char* nombres_ventana[] = { "proyectos_activos", "asignaciones_en_rango", "reporte_sobreasignacion" };
+            const size_t qv = tipo == 2 ? 20 : 200;
+            for (size_t k = 0; k <= qv; ++k) {
+                Fecha d = Fecha::desdeCivil(2015 + (int)gen.rango(12), 1 + (int)gen.rango(12), 1);
+                ventana.limpiar();
+                if (k == 0) t0 = chrono::steady_clock::now();
+                if (tipo == 0) gs.proyectosActivos(d, d, ventana);
+                else if (tipo == 1) gs.asignacionesEntre(d, d, ventana);
+                else gs.reporteSobreasignacion(d, Fecha(d.dias() + 30), ventana);
+                if (k == 0) {
+                    reportar_medicion(out, (string(nombres_ventana[tipo]) + "_fria").c_str(), n, f, 1, segundos_desde(t0));
+                    t0 = chrono::steady_clock::now();
+                }
+            }
+            reportar_medicion(out, nombres_ventana[tipo], n, f, qv, segundos_desde(t0));
+        }
+
+        // equipos en lote: hasta 10000 empleados consecutivos (desde uno al azar) a cada uno
+        // de 3 proyectos nuevos por llamada; comparable con "asignar", que tambien avanza en orden
+        {
+            const size_t equipo = n < 10000 ? n : 10000, llamadas = 5;
+            vector<string> carnets(equipo);
+            size_t total = 0;
+            vector<ResultadoEquipo> res;
+            chrono::steady_clock::duration acumulado(0);
+            for (size_t k = 0; k < llamadas; ++k) {
+                vector<string> nuevos(3);
+                for (size_t j = 0; j < nuevos.size(); ++j) {
+                    nuevos[j] = "EQ-" + to_string(k * 3 + j);
+                    gs.crearProyecto(nuevos[j], "Equipo " + nuevos[j], "2024-01-01", "2026-12-31", error);
+                }
+                size_t desde = gen.rango(n);
+                for (size_t i = 0; i < equipo; ++i) carnets[i] = emps[(desde + i) % n].carnet;
+                t0 = chrono::steady_clock::now();
+                gs.asignarEquipo(carnets, nuevos, res, error);
+                acumulado += chrono::steady_clock::now() - t0;
+                total += res.size();
+            }
+            reportar_medicion(out, "asignar_equipo", n, f, total, chrono::duration<double>(acumulado).count());
+            for (size_t k = 0; k < llamadas * 3; ++k) gs.eliminarProyecto("EQ-" + to_string(k), error); // estado de antes
+        }
+
+        // bajas al final (cambian el estado): una asignacion y luego el empleado completo
+        // para el primer decimo; despues un decimo de los proyectos con sus asignaciones
+        const size_t nb = n / 10, mb = m / 10 ? m / 10 : 1;
+        t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < nb; ++i) gs.quitarAsignacion(emps[i].carnet, codigos[primero[i]], error);
+        reportar_medicion(out, "quitar_asignacion", n, f, nb, segundos_desde(t0));
+        t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < nb; ++i) gs.eliminarEmpleado(emps[i].carnet, error);
+        reportar_medicion(out, "eliminar_empleado", n, f, nb, segundos_desde(t0));
+        t0 = chrono::steady_clock::now();
+        for (size_t j = 0; j < mb; ++j) gs.eliminarProyecto(codigos[j], error);
+        reportar_medicion(out, "eliminar_proyecto", n, f, mb, segundos_desde(t0));
+        if (gs.totalEmpleados() != n - nb || gs.totalProyectos() != m - mb)
+            cerr << "Aviso: bajas inconsistentes\n";
+    }
+}
+
+// ---- autoverificacion (--pruebas) ----
+// deterministica y sin hilos: ida y vuelta del snapshot, rechazo de snapshots corruptos
+// o con duplicados e invariantes tras bajas y compactaciones. 'ruta' es el archivo de
+// trabajo (se borra al terminar); devuelve la cantidad de fallas
+static size_t pruebas(const string& ruta) {
+    size_t hechas = 0, fallas = 0;
+    auto comprobar = [&](bool ok, const string& que) {
+        ++hechas;
+        if (!ok) ++fallas;
+        cout << (ok ? "ok    " : "FALLA ") << que << "\n";
+    };
+    auto exportado = [](const GestorSistema& g, TipoExportacion t) {
+        stringstream os;
+        ReporteExportacion rep;
+        g.exportar(t, os, false, rep, 1);
+        return os.str();
+    };
+    auto guardar = [&](const GestorSistema& g, string& error) {
+        GestorSistema::Imagen img;
+        g.capturarImagen(img);
+        return GestorSistema::escribirSnapshot(img, ruta, error);
+    };
+    string error;
+    cout << "--- PRUEBAS ---\n";
+
+    // ida y vuelta con altas, cambios y bajas (el orden de alta ya no es el de las tablas)
+    GestorSistema gs;
+    {
+        GeneradorSintetico gen(20240601ULL);
+        vector<GeneradorSintetico::DatosEmpleado> emps(3000);
+        for (size_t i = 0; i < emps.size(); ++i) {
+            gen.empleado(i, emps[i]);
+            const GeneradorSintetico::DatosEmpleado& e = emps[i];
+            gs.crearEmpleado(e.carnet, e.nombre, e.fecha_nacimiento, e.categoria, e.salario,
+                             e.direccion, e.telefono, e.correo, error);
+        }
+        vector<string> codigos(40);
+        for (size_t j = 0; j < codigos.size(); ++j) {
+            string nombre, inicio, fin;
+            gen.proyecto(j, codigos[j], nombre, inicio, fin);
+            gs.crearProyecto(codigos[j], nombre, inicio, fin, error);
+        }
+        for (size_t i = 0; i < emps.size(); ++i)
+            for (size_t k = 0; k < 3; ++k)
+                gs.asignarEmpleadoAProyecto(emps[i].carnet, codigos[(i * 7 + k * 5) % codigos.size()], error);
+        for (size_t i = 0; i < emps.size(); i += 11) gs.cambiarCorreoEmpleado(emps[i].carnet, "c" + emps[i].correo, error);
+        for (size_t i = 0; i < emps.size(); i += 7) gs.eliminarEmpleado(emps[i].carnet, error);
+        for (size_t i = 3; i < emps.size(); i += 13) gs.quitarAsignacion(emps[i].carnet, codigos[(i * 7) % codigos.size()], error);
+        gs.cambiarNombreProyecto(codigos[1], "Proyecto renombrado", error);
+        gs.eliminarProyecto(codigos[0], error);
+    }
+    comprobar(guardar(gs, error), "escribir snapshot");
+    {
+        GestorSistema cargado;
+        bool ok = cargado.cargarSnapshot(ruta, error);
+        comprobar(ok && cargado.consistente() && cargado.totalEmpleados() == gs.totalEmpleados() &&
+                  cargado.totalProyectos() == gs.totalProyectos() &&
+                  cargado.totalAsignaciones() == gs.totalAsignaciones(), "snapshot: ida y vuelta");
+        bool iguales = true;
+        for (int t = 0; t < 3; ++t) iguales = iguales && exportado(cargado, (TipoExportacion)t) == exportado(gs, (TipoExportacion)t);
+        comprobar(ok && iguales, "snapshot: mismas tablas en el mismo orden de alta");
+    }
+
+    // cada corrupcion se aplica sobre el snapshot valido y debe rechazarse entera
+    string base;
+    {
+        ifstream in(ruta.c_str(), ios::in | ios::binary);
+        stringstream ss;
+        ss << in.rdbuf();
+        base = ss.str();
+    }
+    CabeceraSnapshot cab;
+    if (base.size() >= sizeof(cab)) std::memcpy(&cab, base.data(), sizeof(cab));
+    else std::memset(&cab, 0, sizeof(cab));
+    static const char* casos[] = {
+        "empleado duplicado", "proyecto duplicado", "asignacion duplicada", "salario NaN",
+        "salario fuera de rango", "empleado menor de edad", "categoria invalida",
+        "cadena fuera de la tabla", "asignacion a un empleado inexistente", "archivo truncado"
+    };
+    for (size_t k = 0; k < sizeof(casos) / sizeof(casos[0]) && base.size() >= sizeof(cab); ++k) {
+        string d = base;
+        char* emp = &d[(size_t)cab.off_empleados];
+        char* proy = &d[(size_t)cab.off_proyectos];
+        char* asig = &d[(size_t)cab.off_asignaciones];
+        EmpleadoDisco e;
+        AsignacionDisco a;
+        std::memcpy(&e, emp, sizeof(e));
+        std::memcpy(&a, asig, sizeof(a));
+        switch (k) {
+        case 0: std::memcpy(emp, emp + sizeof(EmpleadoDisco), sizeof(EmpleadoDisco)); break;
+        case 1: std::memcpy(proy, proy + sizeof(ProyectoDisco), sizeof(ProyectoDisco)); break;
+        case 2: std::memcpy(asig, asig + sizeof(AsignacionDisco), sizeof(AsignacionDisco)); break;
+        case 3: e.salario = std::numeric_limits<double>::quiet_NaN(); break;
+        case 4: e.salario = 1.0; break;
+        case 5: e.fecha_nacimiento = Fecha::hoy().dias() - 365; break;
+        case 6: e.categoria = NUM_CATEGORIAS; break;
+        case 7: e.nombre = (uint32_t)cab.tam_cadenas; break;
+        case 8: a.empleado = (uint32_t)cab.n_empleados; break;
+        default: d.resize(d.size() - sizeof(AsignacionDisco) / 2); break;
+        }
+        if (k >= 3 && k <= 7) std::memcpy(emp, &e, sizeof(e));
+        if (k == 8) std::memcpy(asig, &a, sizeof(a));
+        {
+            ofstream out(ruta.c_str(), ios::out | ios::binary | ios::trunc);
+            out.write(d.data(), (streamsize)d.size());
+        }
+        GestorSistema g;
+        error.clear();
+        bool ok = g.cargarSnapshot(ruta, error);
+        comprobar(!ok && !error.empty(), string("snapshot rechazado: ") + casos[k]);
+    }
+
+    // rotacion: casi todo lo dado de alta se da de baja, asi las cadenas y los frios
+    // sueltos disparan varias compactaciones; una Imagen tomada a mitad de una la
+    // comparte y su snapshot tiene que salir completo
+    {
+        GestorSistema rot;
+        const size_t vivos = 2000, vueltas = 30000;
+        size_t mem_emp, mem_asig, cad0 = 0, fr0 = 0, cad = 0, fr = 0, en_imagen = 0;
+        bool siempre = rot.crearProyecto("ROT", "Rotacion", "2020-01-01", "2030-12-31", error);
+        GestorSistema::Imagen img;
+        for (size_t i = 0; i < vueltas; ++i) {
+            string c = "R" + to_string(i);
+            siempre = rot.crearEmpleado(c, "Rotado " + c, "1980-01-01", "Peon", 300000.0, "Calle " + c,
+                                        to_string(i), c + "@rot.com", error) && siempre;
+            rot.asignarEmpleadoAProyecto(c, "ROT", error);
+            if (i >= vivos) {
+                string v = "R" + to_string(i - vivos);
+                if (i % 3 == 0) rot.cambiarCorreoEmpleado(v, "x" + v + "@rot.com", error);
+                siempre = rot.eliminarEmpleado(v, error) && siempre;
+            }
+            if (i + 1 == vivos) rot.usoMemoria(mem_emp, mem_asig, cad0, fr0);
+            if (i == vueltas / 3) {
+                rot.capturarImagen(img);
+                en_imagen = img.empleados.size();
+            }
+            if (i == 2 * vueltas / 3) {
+                GestorSistema copia;
+                bool ok = GestorSistema::escribirSnapshot(img, ruta, error) && copia.cargarSnapshot(ruta, error);
+                comprobar(ok && copia.totalEmpleados() == en_imagen && copia.consistente(),
+                          "snapshot de una imagen tomada durante las compactaciones");
+                img = GestorSistema::Imagen();
+            }
+            if (i % 1000 == 0) siempre = rot.consistente() && siempre;
+        }
+        comprobar(siempre && rot.consistente() && rot.totalEmpleados() == vivos &&
+                  rot.totalAsignaciones() == vivos, "invariantes tras bajas y compactaciones");
+        rot.usoMemoria(mem_emp, mem_asig, cad, fr);
+        comprobar(cad <= 4 * cad0 && fr <= 4 * fr0, "las compactaciones devuelven la memoria de las bajas");
+        bool ok = guardar(rot, error);
+        GestorSistema cargado;
+        ok = ok && cargado.cargarSnapshot(ruta, error);
+        comprobar(ok && cargado.consistente() &&
+                  exportado(cargado, EXPORTAR_EMPLEADOS) == exportado(rot, EXPORTAR_EMPLEADOS) &&
+                  exportado(cargado, EXPORTAR_ASIGNACIONES) == exportado(rot, EXPORTAR_ASIGNACIONES),
+                  "snapshot tras las compactaciones: ida y vuelta");
+    }
+    std::remove(ruta.c_str());
+    cout << hechas << " comprobaciones, " << fallas << " fallas\n";
+    return fallas;
+}
+
+// ---- protocolo de comandos de una linea (servidor local y, en general, cualquier flujo) ----
+// peticion:  COMANDO|campo|campo...  (una por linea; los nombres no distinguen mayusculas)
+// respuesta: "OK <n>" seguido de n lineas de datos, o "ERR <codigo> <mensaje>"
+//   PING
+//   EMP|carnet|nombre|fecha_nac|categoria|salario|direccion|telefono|correo   (salario vacio -> 250000)
+//   PROY|codigo|nombre|fecha_inicio|fecha_fin
+//   ASIG|carnet|codigo
+//   EQUIPO|codigo[,codigo...]|carnet[|carnet...]
+//                                (todo o nada; una linea por par y al final "ASIGNADAS <n>")
+//   BAJA_EMP|carnet   BAJA_PROY|codigo   DESASIG|carnet|codigo   (las bajas quitan tambien sus asignaciones)
+//   EXISTE_EMP|carnet            EXISTE_PROY|codigo
+//   EMPLEADOS   PROYECTOS   EMPLEADOS_DE|codigo   PROYECTOS_DE|carnet
+//   PAGINA|token                 (token de CursorListado; la ultima linea es "SIGUIENTE <token>" o "SIGUIENTE -")
+//   NOMINA[|codigo]   COSTOS[|codigo]   (COSTOS lee las cifras materializadas de cada proyecto)
+//   ESTADISTICAS                 (un objeto JSON por linea: operaciones y luego motivos de rechazo)
+//   CONSULTA|categoria|salario_min|salario_max|edad_min|edad_max|prefijo_nombre|prefijo_correo[|limite]
+//                                (campos vacios no filtran; la ultima linea es "PLAN <plan> <candidatos> <coincidencias>")
+//   BUSCAR|nombre|texto[|k]   BUSCAR|correo|texto[|k]   BUSCAR|proyecto|texto[|k]
+//                                (los k mas parecidos, 10 por defecto; la ultima linea es "REVISADOS <textos>")
+//   ACTIVOS|desde[|hasta]   ASIGNADOS|desde[|hasta]   SOBREASIGNADOS|desde[|hasta]
+//                                (fechas YYYY-MM-DD inclusivas; sin 'hasta' es un solo dia)
+enum EstadoComando {
+    CMD_OK            = 0,
+    CMD_SINTAXIS      = 1, // cantidad de campos o formato invalido
+    CMD_DESCONOCIDO   = 2,
+    CMD_RECHAZADO     = 3, // validacion, unicidad o asignacion repetida
+    CMD_NO_ENCONTRADO = 4
+};
+
+static void separar_campos(const string& linea, vector<string>& campos) {
+    campos.clear();
+    size_t ini = 0;
+    while (true) {
+        size_t fin = linea.find('|', ini);
+        if (fin == string::npos) { campos.push_back(linea.substr(ini)); return; }
+        campos.push_back(linea.substr(ini, fin - ini));
+        ini = fin + 1;
+    }
+}
+
+// criterios de consulta en texto (protocolo y menu), en el orden de CONSULTA; vacio: sin filtro
+static const int CAMPOS_CONSULTA = 7;
+static bool leer_consulta(const string campos[CAMPOS_CONSULTA], Fecha hoy, ConsultaEmpleados& q, string& error) {
+    if (!campos[0].empty()) {
+        Categoria c;
+        if (!texto_a_categoria(campos[0], c)) { error = "Categoria invalida."; return false; }
+        q.filtrarCategoria(c);
+    }
+    for (int k = 1; k <= 2; ++k) {
+        if (campos[k].empty()) continue;
+        char* fin = NULL;
+        double v = std::strtod(campos[k].c_str(), &fin);
+        if (fin == campos[k].c_str() || *fin) { error = "Salario invalido."; return false; }
+        (k == 1 ? q.salario_min : q.salario_max) = v;
+    }
+    for (int k = 3; k <= 4; ++k) {
+        if (campos[k].empty()) continue;
+        int edad = 0, usados = 0;
+        if (std::sscanf(campos[k].c_str(), "%d%n", &edad, &usados) != 1 || usados != (int)campos[k].size() ||
+            edad < 0 || edad > 200) {
+            error = "Edad invalida.";
+            return false;
+        }
+        if (k == 3) q.edadMinima(edad, hoy);
+        else q.edadMaxima(edad, hoy);
+    }
+    q.prefijo_nombre = campos[5];
+    q.prefijo_correo = campos[6];
+    return true;
+}
+
+// lista de llaves separadas por comas o espacios (vacios ignorados)
+static void separar_lista(const string& texto, vector<string>& llaves) {
+    llaves.clear();
+    size_t i = 0;
+    while (i < texto.size()) {
+        while (i < texto.size() && (texto[i] == ',' || isspace((unsigned char)texto[i]))) ++i;
+        size_t ini = i;
+        while (i < texto.size() && texto[i] != ',' && !isspace((unsigned char)texto[i])) ++i;
+        if (i > ini) llaves.push_back(texto.substr(ini, i - ini));
+    }
+}
+
+// ventana de fechas inclusiva; 'hasta' vacio -> el mismo dia
+static bool leer_ventana(const string& desde, const string& hasta, Fecha& d, Fecha& h, string& error) {
+    if (!Fecha::parsear(desde, d) || (!hasta.empty() && !Fecha::parsear(hasta, h))) {
+        error = "Fecha invalida (use YYYY-MM-DD).";
+        return false;
+    }
+    if (hasta.empty()) h = d;
+    if (h < d) { error = "La fecha final no puede ser anterior a la inicial."; return false; }
+    return true;
+}
+
+class ProcesadorComandos {
+private:
+    GestorSistema& gs_;
+    vector<string> campos_;
+    BufferSalida cuerpo_;
+
+    static size_t contar_lineas(const string& s) {
+        size_t n = 0;
+        for (size_t i = 0; i < s.size(); ++i) if (s[i] == '\n') ++n;
+        if (!s.empty() && s[s.size() - 1] != '\n') ++n;
+        return n;
+    }
+    EstadoComando error(BufferSalida& out, EstadoComando e, const string& mensaje) {
+        out << "ERR " << (int)e << " " << mensaje << "\n";
+        return e;
+    }
+    EstadoComando ok(BufferSalida& out, const string& datos) {
+        out << "OK " << contar_lineas(datos) << "\n" << datos;
+        if (!datos.empty() && datos[datos.size() - 1] != '\n') out << '\n';
+        return CMD_OK;
+    }
+
+public:
+    explicit ProcesadorComandos(GestorSistema& gs) : gs_(gs) {}
+
+    // ejecuta una linea y agrega su respuesta a 'out'
+    EstadoComando ejecutar(const string& linea, BufferSalida& out) {
+        separar_campos(linea, campos_);
+        const vector<string>& c = campos_;
+        string cmd = a_minusculas(c[0]);
+        string err;
+
+        if (cmd == "ping") {
+            return ok(out, "");
+        }
+        if (cmd == "emp") {
+            if (c.size() != 9) return error(out, CMD_SINTAXIS, "EMP lleva 8 campos.");
+            bool hecho;
+            if (c[5].empty()) {
+                hecho = gs_.crearEmpleado(c[1], c[2], c[3], c[4], c[6], c[7], c[8], err);
+            } else {
+                char* fin = NULL;
+                double sal = std::strtod(c[5].c_str(), &fin);
+                if (fin == c[5].c_str() || *fin) return error(out, CMD_SINTAXIS, "Salario invalido.");
+                hecho = gs_.crearEmpleado(c[1], c[2], c[3], c[4], sal, c[6], c[7], c[8], err);
+            }
+            return hecho ? ok(out, "") : error(out, CMD_RECHAZADO, err);
+        }
+        if (cmd == "proy") {
+            if (c.size() != 5) return error(out, CMD_SINTAXIS, "PROY lleva 4 campos.");
+            return gs_.crearProyecto(c[1], c[2], c[3], c[4], err) ? ok(out, "") : error(out, CMD_RECHAZADO, err);
+        }
+        if (cmd == "asig") {
+            if (c.size() != 3) return error(out, CMD_SINTAXIS, "ASIG lleva 2 campos.");
+            if (gs_.asignarEmpleadoAProyecto(c[1], c[2], err)) return ok(out, "");
+            return error(out, err.compare(0, 9, "No existe") == 0 ? CMD_NO_ENCONTRADO : CMD_RECHAZADO, err);
+        }
+        if (cmd == "equipo") {
+            if (c.size() < 3) return error(out, CMD_SINTAXIS, "EQUIPO lleva los proyectos y al menos un carnet.");
+            vector<string> codigos, carnets(c.begin() + 2, c.end());
+            separar_lista(c[1], codigos);
+            if (codigos.empty()) return error(out, CMD_SINTAXIS, "Faltan los proyectos.");
+            vector<ResultadoEquipo> res;
+            // solo falla por llaves inexistentes o por el diario. ERR es de una sola linea, asi
+            // que no lleva los pares: el mensaje ya nombra todas las llaves que faltan y los
+            // demas pares no cambiaron nada
+            if (!gs_.asignarEquipo(carnets, codigos, res, err))
+                return error(out, err.compare(0, 9, "No existe") == 0 ? CMD_NO_ENCONTRADO : CMD_RECHAZADO, err);
+            cuerpo_.limpiar();
+            size_t asignadas = 0;
+            for (size_t k = 0; k < res.size(); ++k) {
+                asignadas += res[k].estado == EQUIPO_ASIGNADO;
+                cuerpo_ << "- " << carnets[res[k].carnet] << " | " << codigos[res[k].proyecto]
+                        << " | " << NOMBRES_ESTADO_EQUIPO[res[k].estado] << "\n";
+            }
+            cuerpo_ << "ASIGNADAS " << asignadas << "\n";
+            return ok(out, cuerpo_.str());
+        }
+        if (cmd == "baja_emp" || cmd == "baja_proy") {
+            if (c.size() != 2) return error(out, CMD_SINTAXIS, "Falta la llave.");
+            bool hecho = cmd == "baja_emp" ? gs_.eliminarEmpleado(c[1], err) : gs_.eliminarProyecto(c[1], err);
+            return hecho ? ok(out, "") : error(out, CMD_NO_ENCONTRADO, err);
+        }
+        if (cmd == "desasig") {
+            if (c.size() != 3) return error(out, CMD_SINTAXIS, "DESASIG lleva 2 campos.");
+            return gs_.quitarAsignacion(c[1], c[2], err) ? ok(out, "") : error(out, CMD_NO_ENCONTRADO, err);
+        }
+        if (cmd == "existe_emp" || cmd == "existe_proy") {
+            if (c.size() != 2) return error(out, CMD_SINTAXIS, "Falta la llave.");
+            bool existe = cmd == "existe_emp" ? gs_.existeEmpleado(c[1]) : gs_.existeProyecto(c[1]);
+            return existe ? ok(out, "") : error(out, CMD_NO_ENCONTRADO, "No existe.");
+        }
+        if (cmd == "empleados" || cmd == "proyectos" || cmd == "empleados_de" || cmd == "proyectos_de") {
+            bool con_llave = cmd == "empleados_de" || cmd == "proyectos_de";
+            if (c.size() != (con_llave ? 2u : 1u)) return error(out, CMD_SINTAXIS, "Cantidad de campos invalida.");
+            if (cmd == "empleados_de" && !gs_.existeProyecto(c[1])) return error(out, CMD_NO_ENCONTRADO, "Proyecto no encontrado.");
+            if (cmd == "proyectos_de" && !gs_.existeEmpleado(c[1])) return error(out, CMD_NO_ENCONTRADO, "Empleado no encontrado.");
+            ostringstream os;
+            if (cmd == "empleados")         gs_.listarEmpleados(os);
+            else if (cmd == "proyectos")    gs_.listarProyectos(os);
+            else if (cmd == "empleados_de") gs_.listarEmpleadosDeProyecto(c[1], os);
+            else                            gs_.listarProyectosDeEmpleado(c[1], os);
+            return ok(out, os.str());
+        }
+        if (cmd == "pagina") {
+            CursorListado cur;
+            // el token puede traer '|' en la llave: se toma el resto de la linea
+            if (c.size() < 2 || !cur.leerToken(linea.substr(linea.find('|') + 1)))
+                return error(out, CMD_SINTAXIS, "Token de pagina invalido.");
+            cuerpo_.limpiar();
+            PaginaListado pag = gs_.listarPagina(cur, cuerpo_);
+            if (!pag.encontrado) return error(out, CMD_NO_ENCONTRADO, cuerpo_.str().substr(0, cuerpo_.str().size() - 1));
+            if (pag.hay_siguiente) { cur.siguiente(); cuerpo_ << "SIGUIENTE " << cur.token() << "\n"; }
+            else cuerpo_ << "SIGUIENTE -\n";
+            return ok(out, cuerpo_.str());
+        }
+        if (cmd == "nomina") {
+            if (c.size() > 2) return error(out, CMD_SINTAXIS, "NOMINA lleva a lo sumo un campo.");
+            string codigo = c.size() == 2 ? c[1] : string();
+            if (!codigo.empty() && !gs_.existeProyecto(codigo)) return error(out, CMD_NO_ENCONTRADO, "Proyecto no encontrado.");
+            ostringstream os;
+            gs_.reporteNomina(codigo, os);
+            return ok(out, os.str());
+        }
+        if (cmd == "costos") {
+            if (c.size() > 2) return error(out, CMD_SINTAXIS, "COSTOS lleva a lo sumo un campo.");
+            string codigo = c.size() == 2 ? c[1] : string();
+            if (!codigo.empty() && !gs_.existeProyecto(codigo)) return error(out, CMD_NO_ENCONTRADO, "Proyecto no encontrado.");
+            ostringstream os;
+            gs_.reporteCostosProyectos(codigo, os);
+            return ok(out, os.str());
+        }
+        if (cmd == "consulta") {
+            if (c.size() != CAMPOS_CONSULTA + 1 && c.size() != CAMPOS_CONSULTA + 2)
+                return error(out, CMD_SINTAXIS, "CONSULTA lleva 7 campos y un limite opcional.");
+            ConsultaEmpleados q;
+            if (!leer_consulta(&c[1], Fecha::hoy(), q, err)) return error(out, CMD_SINTAXIS, err);
+            if (c.size() == CAMPOS_CONSULTA + 2 && !c[8].empty()) {
+                unsigned long lim = 0;
+                int usados = 0;
+                if (std::sscanf(c[8].c_str(), "%lu%n", &lim, &usados) != 1 || usados != (int)c[8].size())
+                    return error(out, CMD_SINTAXIS, "Limite invalido.");
+                q.limite = lim;
+            }
+            cuerpo_.limpiar();
+            ResultadoConsulta res = gs_.consultarEmpleados(q, cuerpo_);
+            cuerpo_ << "PLAN " << NOMBRES_PLAN[res.plan] << " " << res.candidatos << " " << res.coincidencias << "\n";
+            return ok(out, cuerpo_.str());
+        }
+        if (cmd == "buscar") {
+            if (c.size() != 3 && c.size() != 4) return error(out, CMD_SINTAXIS, "BUSCAR lleva campo, texto y un k opcional.");
+            CampoBusqueda campo;
+            if (!texto_a_campo_busqueda(c[1], campo)) return error(out, CMD_SINTAXIS, "Campo de busqueda invalido.");
+            if (c[2].empty()) return error(out, CMD_SINTAXIS, "Texto de busqueda vacio.");
+            unsigned long k = 10;
+            if (c.size() == 4 && !c[3].empty()) {
+                int usados = 0;
+                if (std::sscanf(c[3].c_str(), "%lu%n", &k, &usados) != 1 || usados != (int)c[3].size() || k == 0)
+                    return error(out, CMD_SINTAXIS, "k invalido.");
+            }
+            cuerpo_.limpiar();
+            size_t revisados = gs_.buscarAproximado(campo, c[2], k, cuerpo_);
+            cuerpo_ << "REVISADOS " << revisados << "\n";
+            return ok(out, cuerpo_.str());
+        }
+        if (cmd == "activos" || cmd == "asignados" || cmd == "sobreasignados") {
+            if (c.size() != 2 && c.size() != 3) return error(out, CMD_SINTAXIS, "Se espera desde y un hasta opcional.");
+            Fecha desde, hasta;
+            if (!leer_ventana(c[1], c.size() == 3 ? c[2] : string(), desde, hasta, err)) return error(out, CMD_SINTAXIS, err);
+            cuerpo_.limpiar();
+            if (cmd == "activos") gs_.proyectosActivos(desde, hasta, cuerpo_);
+            else if (cmd == "asignados") gs_.asignacionesEntre(desde, hasta, cuerpo_);
+            else gs_.reporteSobreasignacion(desde, hasta, cuerpo_);
+            return ok(out, cuerpo_.str());
+        }
+        if (cmd == "estadisticas") {
+            if (c.size() != 1) return error(out, CMD_SINTAXIS, "ESTADISTICAS no lleva campos.");
+            ostringstream os;
+            gs_.volcarEstadisticas(os);
+            return ok(out, os.str());
+        }
+        return error(out, CMD_DESCONOCIDO, "Comando desconocido: " + c[0]);
+    }
+};
+
+
+// ---- servidor local (socket Unix o TCP en 127.0.0.1) ----
+#ifndef _WIN32
+static volatile sig_atomic_t detener_servidor = 0;
+static void al_recibir_senal(int) { detener_servidor = 1; }
+
+static bool poner_no_bloqueante(int fd) {
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl >= 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+
+// direccion: "unix:/ruta/al/socket" o "tcp:puerto"
+static int abrir_socket(const string& direccion, bool escuchar, string& error) {
+    int fd = -1;
+    if (direccion.compare(0, 5, "unix:") == 0) {
+        string ruta = direccion.substr(5);
+        struct sockaddr_un dir;
+        std::memset(&dir, 0, sizeof(dir));
+        dir.sun_family = AF_UNIX;
+        if (ruta.empty() || ruta.size() >= sizeof(dir.sun_path)) { error = "Ruta de socket invalida."; return -1; }
+        std::memcpy(dir.sun_path, ruta.c_str(), ruta.size());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) { error = strerror(errno); return -1; }
+        if (escuchar) unlink(ruta.c_str()); // socket viejo de una ejecucion anterior
+        int r = escuchar ? bind(fd, (struct sockaddr*)&dir, sizeof(dir))
+                         : connect(fd, (struct sockaddr*)&dir, sizeof(dir));
+        if (r != 0) { error = strerror(errno); close(fd); return -1; }
+    } else if (direccion.compare(0, 4, "tcp:") == 0) {
+        int puerto = atoi(direccion.c_str() + 4);
+        if (puerto <= 0 || puerto > 65535) { error = "Puerto invalido."; return -1; }
+        struct sockaddr_in dir;
+        std::memset(&dir, 0, sizeof(dir));
+        dir.sin_family = AF_INET;
+        dir.sin_port = htons((uint16_t)puerto);
+        dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // solo local
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) { error = strerror(errno); return -1; }
+        int uno = 1;
+        if (escuchar) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+        else setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &uno, sizeof(uno));
+        int r = escuchar ? bind(fd, (struct sockaddr*)&dir, sizeof(dir))
+                         : connect(fd, (struct sockaddr*)&dir, sizeof(dir));
+        if (r != 0) { error = strerror(errno); close(fd); return -1; }
+    } else {
+        error = "Direccion invalida (use unix:/ruta o tcp:puerto).";
+        return -1;
+    }
+    if (escuchar && listen(fd, 128) != 0) { error = strerror(errno); close(fd); return -1; }
+    return fd;
+}
+
+// bucle de eventos de un solo hilo con poll(): cada conexion acumula lineas y todas
+// las peticiones completas de un read() se ejecutan seguidas (pipelining); las
+// respuestas salen en el mismo orden, escritas cuando el socket lo permite
+static int ejecutar_servidor(GestorSistema& gs, Persistencia* pers, const string& direccion) {
+    const size_t MAX_LINEA = 1 << 20;         // peticion sin '\n' mas larga: se corta la conexion
+    const size_t MAX_PENDIENTE = 4 << 20;     // salida sin enviar: se deja de leer (contrapresion)
+    string error;
+    int escucha = abrir_socket(direccion, true, error);
+    if (escucha < 0 || !poner_no_bloqueante(escucha)) {
+        cout << "No se pudo escuchar en " << direccion << ": " << error << "\n";
+        if (escucha >= 0) close(escucha);
+        return 1;
+    }
+    signal(SIGINT, al_recibir_senal);
+    signal(SIGTERM, al_recibir_senal);
+    signal(SIGPIPE, SIG_IGN);
+    cout << "Servidor escuchando en " << direccion << " (Ctrl+C para terminar)\n" << flush;
+
+    struct Conexion {
+        int fd;
+        string entrada;
+        string salida;
+        size_t enviado;
+        bool cerrar;
+    };
+    vector<Conexion> conexiones;
+    vector<struct pollfd> fds;
+    ProcesadorComandos proc(gs);
+    BufferSalida respuesta;
+    vector<char> lectura(1 << 16);
+    unsigned long long atendidas = 0;
+
+    while (!detener_servidor) {
+        fds.resize(conexiones.size() + 1);
+        fds[0].fd = escucha;
+        fds[0].events = POLLIN;
+        for (size_t i = 0; i < conexiones.size(); ++i) {
+            Conexion& c = conexiones[i];
+            fds[i + 1].fd = c.fd;
+            fds[i + 1].events = (short)((c.salida.size() - c.enviado < MAX_PENDIENTE && !c.cerrar ? POLLIN : 0) |
+                                        (c.enviado < c.salida.size() ? POLLOUT : 0));
+            fds[i + 1].revents = 0;
+        }
+        fds[0].revents = 0;
+        int listos = poll(&fds[0], fds.size(), 1000);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            cout << "Error en poll: " << strerror(errno) << "\n";
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            while (true) {
+                int fd = accept(escucha, NULL, NULL);
+                if (fd < 0) break;
+                poner_no_bloqueante(fd);
+                Conexion c;
+                c.fd = fd;
+                c.enviado = 0;
+                c.cerrar = false;
+                conexiones.push_back(c);
+            }
+        }
+
+        for (size_t i = 0; i + 1 < fds.size(); ++i) {
+            Conexion& c = conexiones[i];
+            short ev = fds[i + 1].revents;
+            if (ev & (POLLIN | POLLHUP | POLLERR)) {
+                while (true) {
+                    ssize_t n = read(c.fd, &lectura[0], lectura.size());
+                    if (n > 0) { c.entrada.append(&lectura[0], (size_t)n); continue; }
+                    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) c.cerrar = true;
+                    if (n < 0 && errno == EINTR) continue;
+                    break;
+                }
+                size_t ini = 0, fin;
+                while ((fin = c.entrada.find('\n', ini)) != string::npos) {
+                    string linea = c.entrada.substr(ini, fin - ini);
+                    ini = fin + 1;
+                    if (!linea.empty() && linea[linea.size() - 1] == '\r') linea.erase(linea.size() - 1);
+                    if (linea.empty()) continue;
+                    if (a_minusculas(linea) == "quit") { c.cerrar = true; break; }
+                    proc.ejecutar(linea, respuesta);
+                    ++atendidas;
+                }
+                c.entrada.erase(0, ini);
+                if (c.entrada.size() > MAX_LINEA) {
+                    respuesta << "ERR " << (int)CMD_SINTAXIS << " Linea demasiado larga.\n";
+                    c.entrada.clear();
+                    c.cerrar = true;
+                }
+                c.salida.append(respuesta.str());
+                respuesta.limpiar();
+            }
+            while (c.enviado < c.salida.size()) {
+                ssize_t n = send(c.fd, c.salida.data() + c.enviado, c.salida.size() - c.enviado, MSG_NOSIGNAL);
+                if (n > 0) { c.enviado += (size_t)n; continue; }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) { c.cerrar = true; c.salida.clear(); c.enviado = 0; }
+                break;
+            }
+            if (c.enviado == c.salida.size()) { c.salida.clear(); c.enviado = 0; }
+            else if (c.enviado > (1 << 20)) { c.salida.erase(0, c.enviado); c.enviado = 0; }
+        }
+
+        // se cierran las conexiones terminadas una vez enviado lo pendiente
+        size_t k = 0;
+        for (size_t i = 0; i < conexiones.size(); ++i) {
+            if (conexiones[i].cerrar && conexiones[i].salida.empty()) { close(conexiones[i].fd); continue; }
+            if (k != i) conexiones[k] = std::move(conexiones[i]);
+            ++k;
+        }
+        conexiones.resize(k);
+        if (pers) pers->compactarSiHaceFalta(gs);
+    }
+
+    for (size_t i = 0; i < conexiones.size(); ++i) close(conexiones[i].fd);
+    close(escucha);
+    if (direccion.compare(0, 5, "unix:") == 0) unlink(direccion.c_str() + 5);
+    cout << "Servidor detenido (" << atendidas << " peticiones atendidas).\n";
+    return 0;
+}
+
+// generador de carga: 'conexiones' hilos, cada uno con hasta 'profundidad' peticiones
+// en vuelo; mezcla 20% EMP, 50% EXISTE_EMP, 30% PAGINA
+static void cliente_carga(const string& direccion, unsigned conexiones, size_t peticiones, size_t profundidad) {
+    if (conexiones == 0) conexiones = 1;
+    if (profundidad == 0) profundidad = 1;
+    cout << "--- CARGA CONTRA " << direccion << " (" << conexiones << " conexiones, " << peticiones
+         << " peticiones, profundidad " << profundidad << ") ---\n";
+    atomic<size_t> oks(0), errores(0), fallidas(0);
+    unsigned long long semilla = (unsigned long long)chrono::steady_clock::now().time_since_epoch().count();
+    vector<thread> hilos;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (unsigned h = 0; h < conexiones; ++h) {
+        hilos.push_back(thread([&, h]() {
+            string error;
+            int fd = abrir_socket(direccion, false, error);
+            if (fd < 0) { ++fallidas; return; }
+            size_t mias = peticiones / conexiones + (h < peticiones % conexiones ? 1 : 0);
+            size_t enviadas = 0, recibidas = 0, creados = 0, lineas_cuerpo = 0;
+            bool en_cuerpo = false;
+            string entrada, salida;
+            vector<char> buf(1 << 16);
+            char linea[160];
+            while (recibidas < mias) {
+                salida.clear();
+                while (enviadas < mias && enviadas - recibidas < profundidad) {
+                    size_t r = (size_t)(enviadas * 2654435761u % 100);
+                    if (r < 20 || creados == 0) {
+                        std::snprintf(linea, sizeof(linea),
+                                      "EMP|L%llx-%u-%lu|Carga %lu|1990-01-01|Operario||||c%llx.%u.%lu@carga.com\n",
+                                      semilla, h, (unsigned long)creados, (unsigned long)creados,
+                                      semilla, h, (unsigned long)creados);
+                        ++creados;
+                    } else if (r < 70) {
+                        std::snprintf(linea, sizeof(linea), "EXISTE_EMP|L%llx-%u-%lu\n",
+                                      semilla, h, (unsigned long)(r % creados));
+                    } else {
+                        std::snprintf(linea, sizeof(linea), "PAGINA|0:%d:%lu:20:\n", (int)(r % NUM_ORDENES),
+                                      (unsigned long)(r * 7));
+                    }
+                    salida += linea;
+                    ++enviadas;
+                }
+                size_t hecho = 0;
+                while (hecho < salida.size()) {
+                    ssize_t n = send(fd, salida.data() + hecho, salida.size() - hecho, MSG_NOSIGNAL);
+                    if (n <= 0) { if (n < 0 && errno == EINTR) continue; close(fd); ++fallidas; return; }
+                    hecho += (size_t)n;
+                }
+                ssize_t n = read(fd, &buf[0], buf.size());
+                if (n <= 0) { if (n < 0 && errno == EINTR) continue; close(fd); ++fallidas; return; }
+                entrada.append(&buf[0], (size_t)n);
+                size_t ini = 0, fin;
+                while ((fin = entrada.find('\n', ini)) != string::npos) {
+                    if (en_cuerpo) {
+                        if (--lineas_cuerpo == 0) { en_cuerpo = false; ++recibidas; }
+                    } else if (entrada.compare(ini, 3, "OK ") == 0) {
+                        ++oks;
+                        lineas_cuerpo = (size_t)strtoul(entrada.c_str() + ini + 3, NULL, 10);
+                        if (lineas_cuerpo) en_cuerpo = true;
+                        else ++recibidas;
+                    } else {
+                        ++errores;
+                        ++recibidas;
+                    }
+                    ini = fin + 1;
+                }
+                entrada.erase(0, ini);
+            }
+            close(fd);
+        }));
+    }
+    for (size_t i = 0; i < hilos.size(); ++i) hilos[i].join();
+    double seg = segundos_desde(t0);
+    size_t total = oks.load() + errores.load();
+    cout << total << " respuestas en " << seg << " s (" << (seg > 0 ? total / seg : 0.0) << " peticiones/s), OK "
+         << oks.load() << ", ERR " << errores.load();
+    if (fallidas.load()) cout << ", conexiones fallidas " << fallidas.load();
+    cout << "\n";
+}
+#endif
+
+// ---- modo por lotes: un comando del protocolo por linea, sin menus ni avisos ----
+// Las respuestas van a un buffer que se vuelca por bloques; con solo_errores se
+// imprime unicamente "<linea>: ERR ..." de los comandos fallidos. El resumen por
+// codigo de estado sale por cerr. Devuelve 0 si todos los comandos terminaron en OK.
+static int ejecutar_comandos(GestorSistema& gs, Persistencia* pers, istream& in, bool solo_errores) {
+    const size_t TAM_GRUPO = 4096; // comandos por fflush del diario
+    const int NUM_ESTADOS = CMD_NO_ENCONTRADO + 1;
+    size_t por_estado[NUM_ESTADOS] = { 0 };
+    ProcesadorComandos proc(gs);
+    BufferSalida out(&cout, 1 << 18);
+    BufferSalida respuesta;
+    string linea;
+    size_t nlinea = 0, comandos = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    gs.grupoDiario(true);
+    while (getline(in, linea)) {
+        ++nlinea;
+        if (!linea.empty() && linea[linea.size() - 1] == '\r') linea.erase(linea.size() - 1);
+        if (linea.empty() || linea[0] == '#') continue;
+        EstadoComando e;
+        if (solo_errores) {
+            respuesta.limpiar();
+            e = proc.ejecutar(linea, respuesta);
+            if (e != CMD_OK) out << nlinea << ": " << respuesta.str();
+        } else {
+            e = proc.ejecutar(linea, out);
+        }
+        ++por_estado[e];
+        if (++comandos % TAM_GRUPO == 0) {
+            gs.grupoDiario(false);
+            if (pers) pers->compactarSiHaceFalta(gs);
+            gs.grupoDiario(true);
+        }
+    }
+    gs.grupoDiario(false);
+    out.volcar();
+    cout.flush();
+    // el ultimo grupo se confirma con un solo fflush: si fallo, sus OK no quedaron en disco
+    string caido;
+    bool diario_ok = gs.diarioSano(caido);
+    if (!diario_ok) cerr << caido << "\n";
+
+    static const char* nombres[NUM_ESTADOS] = { "ok", "sintaxis", "desconocido", "rechazado", "no_encontrado" };
+    double seg = segundos_desde(t0);
+    cerr << "Comandos: " << comandos << " en " << seg << " s (" << (seg > 0 ? comandos / seg : 0.0) << " /s)";
+    for (int k = 0; k < NUM_ESTADOS; ++k) cerr << ", " << nombres[k] << "=" << por_estado[k];
+    cerr << "\n";
+    return por_estado[CMD_OK] == comandos && diario_ok ? 0 : 1;
+}
+
+static void imprimir_menu() {
+    cout << "\n--- MENU SISTEMA CONSTRUCTORES AVANCE ---\n";
+    cout << "1) Crear empleado (salario por defecto 250000)\n";
+    cout << "2) Crear empleado (con salario)\n";
+    cout << "3) Listar empleados\n";
+    cout << "4) Crear proyecto\n";
+    cout << "5) Listar proyectos\n";
+    cout << "6) Asignar empleado a proyecto\n";
+    cout << "7) Listar empleados de un proyecto\n";
+    cout << "8) Listar proyectos de un empleado\n";
+    cout << "9) Importar archivo (CSV/JSONL)\n";
+    cout << "10) Guardar snapshot (requiere --datos DIR)\n";
+    cout << "11) Explorar listado por paginas\n";
+    cout << "12) Reporte de nomina\n";
+    cout << "13) Estadisticas de operaciones\n";
+    cout << "14) Eliminar empleado (y sus asignaciones)\n";
+    cout << "15) Eliminar proyecto (y sus asignaciones)\n";
+    cout << "16) Quitar empleado de un proyecto\n";
+    cout << "17) Consultar empleados por criterios\n";
+    cout << "18) Busqueda aproximada (nombre, correo o proyecto)\n";
+    cout << "19) Proyectos activos entre dos fechas\n";
+    cout << "20) Asignaciones hechas entre dos fechas\n";
+    cout << "21) Empleados con proyectos simultaneos (sobreasignacion)\n";
+    cout << "22) Costo de nomina por proyecto\n";
+    cout << "23) Asignar un equipo a uno o varios proyectos\n";
+    cout << "24) Exportar archivo (CSV/JSONL)\n";
+    cout << "0) Salir\n";
+    cout << "Seleccione opcion: ";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        unsigned long n = 20000, consultas = 2000;
+        if (argc > 2) std::sscanf(argv[2], "%lu", &n);
+        if (argc > 3) std::sscanf(argv[3], "%lu", &consultas);
+        benchmark_indices(n, consultas);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-nomina") {
+        unsigned long n = 1000000, repeticiones = 20;
+        if (argc > 2) std::sscanf(argv[2], "%lu", &n);
+        if (argc > 3) std::sscanf(argv[3], "%lu", &repeticiones);
+        if (repeticiones == 0) repeticiones = 1;
+        benchmark_nomina(n, repeticiones);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-suite") {
+        // --bench-suite [max_n] [fanout] [semilla] [archivo.jsonl]
+        unsigned long max_n = 100000, fanout = 3;
+        unsigned long long semilla = 20240601ULL;
+        if (argc > 2) std::sscanf(argv[2], "%lu", &max_n);
+        if (argc > 3) std::sscanf(argv[3], "%lu", &fanout);
+        if (argc > 4) std::sscanf(argv[4], "%llu", &semilla);
+        if (argc > 5) {
+            ofstream salida(argv[5], ios::out | ios::app);
+            if (!salida) { cout << "No se pudo abrir " << argv[5] << "\n"; return 1; }
+            benchmark_suite(max_n, fanout, semilla, salida);
+        } else {
+            benchmark_suite(max_n, fanout, semilla, cout);
+        }
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--pruebas") {
+        // --pruebas [archivo de trabajo]: codigo 1 si alguna comprobacion falla
+        return pruebas(argc > 2 ? argv[2] : "pruebas.tmp") == 0 ? 0 : 1;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-concurrencia") {
+        unsigned long operaciones = 200000;
+        if (argc > 2) std::sscanf(argv[2], "%lu", &operaciones);
+        benchmark_concurrencia(operaciones);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-memoria") {
+        unsigned long n = 200000;
+        if (argc > 2) std::sscanf(argv[2], "%lu", &n);
+        benchmark_memoria(n, argc > 3 ? argv[3] : "");
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-exportacion") {
+        unsigned long n = 1000000;
+        unsigned hilos = 0; // 0 = todos los nucleos
+        if (argc > 2) std::sscanf(argv[2], "%lu", &n);
+        if (argc > 3) std::sscanf(argv[3], "%u", &hilos);
+        benchmark_exportacion(n, hilos);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-importacion") {
+        unsigned long n = 1000000;
+        unsigned hilos = 0; // 0 = todos los nucleos
+        if (argc > 2) std::sscanf(argv[2], "%lu", &n);
+        if (argc > 3) std::sscanf(argv[3], "%u", &hilos);
+        benchmark_importacion(n, hilos, "bench_importacion.csv");
+        return 0;
+    }
+
+    if (argc > 2 && string(argv[1]) == "--cliente-carga") {
+#ifndef _WIN32
+        unsigned conexiones = 4;
+        unsigned long peticiones = 100000, profundidad = 32;
+        if (argc > 3) std::sscanf(argv[3], "%u", &conexiones);
+        if (argc > 4) std::sscanf(argv[4], "%lu", &peticiones);
+        if (argc > 5) std::sscanf(argv[5], "%lu", &profundidad);
+        cliente_carga(argv[2], conexiones, peticiones, profundidad);
+        return 0;
+#else
+        cout << "El cliente de carga requiere sockets POSIX.\n";
+        return 1;
+#endif
+    }
+
+    GestorSistema gs;
+    std::unique_ptr<Persistencia> pers;
+    string servidor, comandos, exportar_tipo, exportar_ruta;
+    bool solo_errores = false;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--solo-errores") solo_errores = true;
+        // --exportar TIPO RUTA: exporta lo cargado con --datos y termina
+        if (i + 2 < argc && string(argv[i]) == "--exportar") { exportar_tipo = argv[i + 1]; exportar_ruta = argv[i + 2]; }
+        if (i + 1 < argc && string(argv[i]) == "--servidor") servidor = argv[i + 1];
+        if (i + 1 < argc && string(argv[i]) == "--comandos") comandos = argv[i + 1];
+    }
+    // en modo por lotes stdout lleva solo las respuestas: los avisos van a cerr
+    if (!comandos.empty()) ios::sync_with_stdio(false);
+    ostream& avisos = comandos.empty() ? cout : cerr;
+    // --frio RUTA [--frio-cache N]: direccion y telefono a disco (antes de cargar datos)
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) != "--frio") continue;
+        unsigned long cache = 10000;
+        for (int k = 1; k + 1 < argc; ++k)
+            if (string(argv[k]) == "--frio-cache") std::sscanf(argv[k + 1], "%lu", &cache);
+        string error;
+        if (!gs.usarAlmacenFrio(argv[i + 1], cache, error)) {
+            avisos << "Error en el almacen frio: " << error << "\n";
+            return 1;
+        }
+    }
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--datos") {
+            pers.reset(new Persistencia(argv[i + 1]));
+            string error;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            if (!pers->abrir(gs, error)) {
+                avisos << "Error al cargar datos: " << error << "\n";
+                return 1;
+            }
+            avisos << "Datos cargados de " << argv[i + 1] << ": " << gs.totalEmpleados() << " empleados, "
+                   << gs.totalProyectos() << " proyectos, " << gs.totalAsignaciones()
+                   << " asignaciones (" << segundos_desde(t0) << " s)\n";
+        }
+    }
+
+    if (!exportar_tipo.empty()) {
+        TipoExportacion t;
+        if (exportar_tipo == "empleados")          t = EXPORTAR_EMPLEADOS;
+        else if (exportar_tipo == "proyectos")     t = EXPORTAR_PROYECTOS;
+        else if (exportar_tipo == "asignaciones")  t = EXPORTAR_ASIGNACIONES;
+        else { cerr << "Tipo de exportacion invalido: " << exportar_tipo << "\n"; return 1; }
+        ReporteExportacion rep;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        if (!gs.exportarArchivo(t, exportar_ruta, rep)) { cerr << "No se pudo escribir " << exportar_ruta << "\n"; return 1; }
+        avisos << "Exportadas " << rep.filas << " filas (" << rep.bytes << " bytes) a " << exportar_ruta
+               << " (" << segundos_desde(t0) << " s)\n";
+        if (pers) pers->cerrar(gs);
+        return 0;
+    }
+
+    if (!comandos.empty()) {
+        int r;
+        if (comandos == "-") {
+            cin.tie(NULL);
+            r = ejecutar_comandos(gs, pers.get(), cin, solo_errores);
+        } else {
+            vector<char> buffer(1 << 20);
+            ifstream in;
+            in.rdbuf()->pubsetbuf(&buffer[0], (streamsize)buffer.size());
+            in.open(comandos.c_str(), ios::in | ios::binary);
+            if (!in) { cerr << "No se pudo abrir " << comandos << "\n"; return 1; }
+            r = ejecutar_comandos(gs, pers.get(), in, solo_errores);
+        }
+        if (pers) pers->cerrar(gs);
+        return r;
+    }
+
+    if (!servidor.empty()) {
+#ifndef _WIN32
+        int r = ejecutar_servidor(gs, pers.get(), servidor);
+        if (pers) pers->cerrar(gs);
+        return r;
+#else
+        cout << "El modo servidor requiere sockets POSIX.\n";
+        return 1;
+#endif
+    }
+
+    while (true) {
+        if (pers) pers->compactarSiHaceFalta(gs);
+        imprimir_menu();
+        int op = leer_opcion();
+
+        if (op == 0) break;
+
+        if (op == 1) {
+            cout << "\n-- Crear empleado (salario por defecto) --\n";
+            string carnet = leer_linea("Carnet: ");
+            string nombre = leer_linea("Nombre: ");
+            string fnac   = leer_linea("Fecha de nacimiento (YYYY-MM-DD): ");
+            string cat    = leer_linea("Categoria (Administrador/Operario/Peon): ");
+            string dir    = leer_linea("Direccion (vacio -> San Jose): ");
+            string tel    = leer_linea("Telefono: ");
+            string corr   = leer_linea("Correo: ");
+            if (!cin) break;
+
+            string error;
+            bool ok = gs.crearEmpleado(carnet, nombre, fnac, cat, dir, tel, corr, error);
+            if (ok) cout << "Empleado creado.\n";
+            else    cout << error << "\nNo se creo el empleado.\n";
+        }
+        else if (op == 2) {
+            cout << "\n-- Crear empleado (con salario) --\n";
+            string carnet = leer_linea("Carnet: ");
+            string nombre = leer_linea("Nombre: ");
+            string fnac   = leer_linea("Fecha de nacimiento (YYYY-MM-DD): ");
+            string cat    = leer_linea("Categoria (Administrador/Operario/Peon): ");
+            double sal    = 0.0;
+            if (!leer_double("Salario (250000..500000): ", sal)) break;
+            string dir    = leer_linea("Direccion (vacio -> San Jose): ");
+            string tel    = leer_linea("Telefono: ");
+            string corr   = leer_linea("Correo: ");
+            if (!cin) break;
+
+            string error;
+            bool ok = gs.crearEmpleado(carnet, nombre, fnac, cat, sal, dir, tel, corr, error);
+            if (ok) cout << "Empleado creado.\n";
+            else    cout << error << "\nNo se creo el empleado.\n";
+        }
+        else if (op == 3) {
+            cout << "\n-- Lista de empleados --\n";
+            gs.listarEmpleados(std::cout);
+        }
+        else if (op == 4) {
+            cout << "\n-- Crear proyecto --\n";
+            string cod  = leer_linea("Codigo del proyecto: ");
+            string nom  = leer_linea("Nombre del proyecto (unico): ");
+            string ini  = leer_linea("Fecha de inicio (YYYY-MM-DD): ");
+            string fin  = leer_linea("Fecha de finalizacion (YYYY-MM-DD): ");
+            if (!cin) break;
+
+            string error;
+            bool ok = gs.crearProyecto(cod, nom, ini, fin, error);
+            if (ok) cout << "Proyecto creado.\n";
+            else    cout << error << "\nNo se creo el proyecto.\n";
+        }
+        else if (op == 5) {
+            cout << "\n-- Lista de proyectos --\n";
+            gs.listarProyectos(std::cout);
+        }
+        else if (op == 6) {
+            cout << "\n-- Asignar empleado a proyecto --\n";
+            string carnet = leer_linea("Carnet del empleado: ");
+            string codigo = leer_linea("Codigo del proyecto: ");
+            if (!cin) break;
+            string error;
+            bool ok = gs.asignarEmpleadoAProyecto(carnet, codigo, error);
+            if (ok) cout << "Asignacion realizada.\n";
+            else    cout << error << "\nNo se realizo la asignacion.\n";
+        }
+        else if (op == 7) {
+            cout << "\n-- Empleados de un proyecto --\n";
+            string codigo = leer_linea("Codigo del proyecto: ");
+            if (!cin) break;
+            gs.listarEmpleadosDeProyecto(codigo, std::cout);
+        }
+        else if (op == 8) {
+            cout << "\n-- Proyectos de un empleado --\n";
+            string carnet = leer_linea("Carnet del empleado: ");
+            if (!cin) break;
+            gs.listarProyectosDeEmpleado(carnet, std::cout);
+        }
+        else if (op == 9) {
+            cout << "\n-- Importar archivo --\n";
+            string tipo = a_minusculas(leer_linea("Tipo (empleados/proyectos/asignaciones): "));
+            if (!cin) break;
+            TipoImportacion t;
+            if (tipo == "empleados")          t = IMPORTAR_EMPLEADOS;
+            else if (tipo == "proyectos")     t = IMPORTAR_PROYECTOS;
+            else if (tipo == "asignaciones")  t = IMPORTAR_ASIGNACIONES;
+            else { cout << "Tipo invalido.\n"; continue; }
+            string ruta = leer_linea("Ruta del archivo (.csv o .jsonl): ");
+            if (!cin) break;
+
+            ReporteImportacion rep;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            if (!gs.importarArchivo(t, ruta, rep)) {
+                if (rep.errores.empty()) cout << "No se pudo abrir el archivo.\n";
+                else cout << "Linea " << rep.errores[0].linea << ": " << rep.errores[0].mensaje << "\n";
+                continue;
+            }
+            cout << "Leidas: " << rep.leidas << ", aceptadas: " << rep.aceptadas
+                 << ", rechazadas: " << rep.errores.size()
+                 << " (" << segundos_desde(t0) << " s)\n";
+            const size_t MAX_EN_PANTALLA = 20;
+            for (size_t i = 0; i < rep.errores.size() && i < MAX_EN_PANTALLA; ++i)
+                cout << "  Linea " << rep.errores[i].linea << ": " << rep.errores[i].mensaje << "\n";
+            if (rep.errores.size() > MAX_EN_PANTALLA) {
+                string ruta_err = ruta + ".errores.txt";
+                ofstream out(ruta_err.c_str());
+                for (size_t i = 0; i < rep.errores.size(); ++i)
+                    out << rep.errores[i].linea << "\t" << rep.errores[i].mensaje << "\n";
+                cout << "  ... reporte completo en " << ruta_err << "\n";
+            }
+        }
+        else if (op == 10) {
+            if (!pers) cout << "Persistencia no activa (inicie con --datos DIR).\n";
+            else if (pers->compactar(gs)) cout << "Snapshot en curso en segundo plano.\n";
+            else cout << "Ya hay un snapshot en curso.\n";
+        }
+        else if (op == 11) {
+            cout << "\n-- Explorar listado por paginas --\n";
+            CursorListado cur;
+            string tipo = a_minusculas(leer_linea("Listado (empleados/proyectos/proyecto/empleado): "));
+            if (tipo == "empleados")      cur.tipo = LISTADO_EMPLEADOS;
+            else if (tipo == "proyectos") cur.tipo = LISTADO_PROYECTOS;
+            else if (tipo == "proyecto")  { cur.tipo = LISTADO_EMPLEADOS_DE_PROYECTO; cur.llave = leer_linea("Codigo del proyecto: "); }
+            else if (tipo == "empleado")  { cur.tipo = LISTADO_PROYECTOS_DE_EMPLEADO; cur.llave = leer_linea("Carnet del empleado: "); }
+            else if (!cin) break;
+            else { cout << "Listado invalido.\n"; continue; }
+            if (!cin) break;
+            string orden = a_minusculas(leer_linea("Orden (insercion/llave/nombre/salario/fecha): "));
+            if (orden == "llave")        cur.orden = ORDEN_LLAVE;
+            else if (orden == "nombre")  cur.orden = ORDEN_NOMBRE;
+            else if (orden == "salario") cur.orden = ORDEN_SALARIO;
+            else if (orden == "fecha")   cur.orden = ORDEN_FECHA;
+            int tam = 0;
+            std::sscanf(leer_linea("Registros por pagina (vacio -> 20): ").c_str(), "%d", &tam);
+            if (tam > 0) cur.tam_pagina = (size_t)tam;
+            if (!cin) break;
+
+            PaginaListado pag;
+            bool redibujar = true;
+            while (true) {
+                if (redibujar) {
+                    BufferSalida out(&cout);
+                    pag = gs.listarPagina(cur, out);
+                    out.volcar();
+                    if (!pag.encontrado) break;
+                }
+                redibujar = true;
+                string nav = a_minusculas(leer_linea("[s]iguiente, [a]nterior, [q] salir: "));
+                if (!cin) break; // el menu lo vuelve a revisar y termina
+                if (nav == "s" && !pag.hay_siguiente) { cout << "Ya esta en la ultima pagina.\n"; redibujar = false; }
+                else if (nav == "s") cur.siguiente();
+                else if (nav == "a") cur.anterior();
+                else break;
+            }
+        }
+        else if (op == 12) {
+            cout << "\n-- Reporte de nomina --\n";
+            string codigo = leer_linea("Codigo del proyecto (vacio -> todos): ");
+            if (!cin) break;
+            if (!codigo.empty() && !gs.existeProyecto(codigo)) { cout << "Proyecto no encontrado.\n"; continue; }
+            gs.reporteNomina(codigo, std::cout);
+        }
+        else if (op == 13) {
+            cout << "\n-- Estadisticas de operaciones --\n";
+            gs.imprimirEstadisticas(std::cout);
+            string ruta = leer_linea("Guardar volcado JSON en (vacio -> no guardar): ");
+            if (!cin) break;
+            if (ruta.empty()) continue;
+            ofstream f(ruta.c_str());
+            if (f) gs.volcarEstadisticas(f);
+            cout << (f ? "Volcado guardado.\n" : "No se pudo escribir el archivo.\n");
+        }
+        else if (op == 14) {
+            cout << "\n-- Eliminar empleado --\n";
+            string carnet = leer_linea("Carnet del empleado: ");
+            if (!cin) break;
+            string error;
+            if (gs.eliminarEmpleado(carnet, error)) cout << "Empleado eliminado.\n";
+            else cout << error << "\n";
+        }
+        else if (op == 15) {
+            cout << "\n-- Eliminar proyecto --\n";
+            string codigo = leer_linea("Codigo del proyecto: ");
+            if (!cin) break;
+            string error;
+            if (gs.eliminarProyecto(codigo, error)) cout << "Proyecto eliminado.\n";
+            else cout << error << "\n";
+        }
+        else if (op == 16) {
+            cout << "\n-- Quitar empleado de un proyecto --\n";
+            string carnet = leer_linea("Carnet del empleado: ");
+            string codigo = leer_linea("Codigo del proyecto: ");
+            if (!cin) break;
+            string error;
+            if (gs.quitarAsignacion(carnet, codigo, error)) cout << "Asignacion eliminada.\n";
+            else cout << error << "\n";
+        }
+        else if (op == 17) {
+            cout << "\n-- Consultar empleados (vacio -> sin filtro) --\n";
+            string campos[CAMPOS_CONSULTA];
+            campos[0] = leer_linea("Categoria (Administrador/Operario/Peon): ");
+            campos[1] = leer_linea("Salario minimo: ");
+            campos[2] = leer_linea("Salario maximo: ");
+            campos[3] = leer_linea("Edad minima: ");
+            campos[4] = leer_linea("Edad maxima: ");
+            campos[5] = leer_linea("El nombre empieza con: ");
+            campos[6] = leer_linea("El correo empieza con: ");
+            if (!cin) break;
+            ConsultaEmpleados q;
+            string error;
+            if (!leer_consulta(campos, Fecha::hoy(), q, error)) { cout << error << "\n"; continue; }
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            BufferSalida out(&cout);
+            ResultadoConsulta res = gs.consultarEmpleados(q, out);
+            out << res.coincidencias << " empleados (plan: " << NOMBRES_PLAN[res.plan] << ", "
+                << res.candidatos << " revisados, " << segundos_desde(t0) * 1000.0 << " ms)\n";
+        }
+        else if (op == 18) {
+            cout << "\n-- Busqueda aproximada --\n";
+            CampoBusqueda campo;
+            if (!texto_a_campo_busqueda(leer_linea("Buscar en (nombre/correo/proyecto): "), campo)) {
+                if (!cin) break;
+                cout << "Campo invalido.\n";
+                continue;
+            }
+            string texto = leer_linea("Texto a buscar: ");
+            if (!cin) break;
+            if (texto.empty()) { cout << "Texto vacio.\n"; continue; }
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            BufferSalida out(&cout);
+            size_t revisados = gs.buscarAproximado(campo, texto, 10, out);
+            out << "(" << revisados << " textos revisados, " << segundos_desde(t0) * 1000.0 << " ms)\n";
+        }
+        else if (op >= 19 && op <= 21) {
+            static const char* titulos[] = {
+                "Proyectos activos", "Asignaciones en el rango", "Sobreasignacion"
+            };
+            cout << "\n-- " << titulos[op - 19] << " --\n";
+            string d = leer_linea("Desde (YYYY-MM-DD): ");
+            string h = leer_linea("Hasta (vacio -> el mismo dia): ");
+            if (!cin) break;
+            Fecha desde, hasta;
+            string error;
+            if (!leer_ventana(d, h, desde, hasta, error)) { cout << error << "\n"; continue; }
+            BufferSalida out(&cout);
+            if (op == 19) out << gs.proyectosActivos(desde, hasta, out) << " proyectos activos.\n";
+            else if (op == 20) out << gs.asignacionesEntre(desde, hasta, out) << " asignaciones.\n";
+            else out << gs.reporteSobreasignacion(desde, hasta, out) << " empleados sobreasignados.\n";
+        }
+        else if (op == 22) {
+            cout << "\n-- Costo de nomina por proyecto --\n";
+            string codigo = leer_linea("Codigo del proyecto (vacio -> todos): ");
+            if (!cin) break;
+            if (!codigo.empty() && !gs.existeProyecto(codigo)) { cout << "Proyecto no encontrado.\n"; continue; }
+            gs.reporteCostosProyectos(codigo, std::cout);
+        }
+        else if (op == 23) {
+            cout << "\n-- Asignar un equipo --\n";
+            vector<string> codigos, carnets;
+            separar_lista(leer_linea("Codigos de los proyectos (separados por comas): "), codigos);
+            separar_lista(leer_linea("Carnets del equipo (separados por comas o espacios): "), carnets);
+            if (!cin) break;
+            if (codigos.empty() || carnets.empty()) { cout << "Faltan proyectos o carnets.\n"; continue; }
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            vector<ResultadoEquipo> res;
+            string error;
+            bool ok = gs.asignarEquipo(carnets, codigos, res, error);
+            double ms = segundos_desde(t0) * 1000.0;
+            size_t cuenta[NUM_ESTADOS_EQUIPO] = {};
+            BufferSalida out(&cout);
+            for (size_t k = 0; k < res.size(); ++k) {
+                ++cuenta[res[k].estado];
+                if (res[k].estado != EQUIPO_ASIGNADO)
+                    out << "- " << carnets[res[k].carnet] << " | " << codigos[res[k].proyecto]
+                        << " | " << NOMBRES_ESTADO_EQUIPO[res[k].estado] << "\n";
+            }
+            if (!ok) out << error << "\nNo se realizo ninguna asignacion.\n";
+            else out << cuenta[EQUIPO_ASIGNADO] << " asignaciones nuevas, " << cuenta[EQUIPO_YA_ASIGNADO]
+                     << " ya existian, " << cuenta[EQUIPO_REPETIDO] << " repetidas (" << ms << " ms).\n";
+        }
+        else if (op == 24) {
+            cout << "\n-- Exportar archivo --\n";
+            string tipo = a_minusculas(leer_linea("Tipo (empleados/proyectos/asignaciones): "));
+            if (!cin) break;
+            TipoExportacion t;
+            if (tipo == "empleados")          t = EXPORTAR_EMPLEADOS;
+            else if (tipo == "proyectos")     t = EXPORTAR_PROYECTOS;
+            else if (tipo == "asignaciones")  t = EXPORTAR_ASIGNACIONES;
+            else { cout << "Tipo invalido.\n"; continue; }
+            string ruta = leer_linea("Ruta del archivo (.csv o .jsonl): ");
+            if (!cin) break;
+            ReporteExportacion rep;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            if (!gs.exportarArchivo(t, ruta, rep)) { cout << "No se pudo escribir el archivo.\n"; continue; }
+            cout << "Exportadas " << rep.filas << " filas (" << rep.bytes << " bytes) en "
+                 << segundos_desde(t0) << " s\n";
+        }
+        else {
+            cout << "Opcion invalida.\n";
+        }
+    }
+
+    // opcion 0 o fin de la entrada (tambien a mitad de un formulario, que no se aplica)
+    if (pers) pers->cerrar(gs);
+    cout << "Saliendo...\n";
+    return 0;
+}
+